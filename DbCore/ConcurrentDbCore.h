@@ -0,0 +1,431 @@
+#pragma once
+#ifndef _CONCURRENTDBCORE_H_
+#define _CONCURRENTDBCORE_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// ConcurrentDbCore.h - thread-safe NoSql database, sharded for parallel access    //
+// ver 1.2                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines a single class, ConcurrentDbCore, that holds the
+* same records as DbCore but may be used from many threads at once.
+*
+* Records are spread over a fixed number of shards by the hash of their
+* keys.  Each shard has its own map and reader/writer lock, on its own
+* cache line, so lookups of different keys rarely touch the same lock,
+* readers of one shard run in parallel, and a writer blocks only the
+* readers of its own shard.
+*
+* A reference into a shard would outlive its lock, so records are handed
+* out as copies (get, find), or visited in place under the lock (read,
+* update, forEach).  DbCore is left unchanged for single threaded use,
+* and copy returns a DbCore holding a consistent image of all shards.
+*
+* An operation that touches several shards - put, insert, addChild,
+* and deleteChild, for a record and its children, or copy, for all of
+* them - takes their locks together, in shard order, so the locks
+* cannot deadlock.  deleteRecord updates the record's parents one after
+* another, so another thread may see the record gone before its key
+* has left every parent's children.
+*
+*   ----------------------------------------------------------
+*   - contains									: is key in db?
+*   - size										: number of records
+*   - keys										: keys of all records
+*   - get										: copy of record for key, throws if there is none
+*   - find										: copies record for key, false if there is none
+*   - put										: inserts or replaces record for key
+*   - insert									: inserts record for key if key is not in db
+*   - read										: calls f(const DbElement&) on record for key, under a read lock
+*   - update									: calls f(DbElement&) on record for key, under a write lock
+*   - forEach									: calls f(key, const DbElement&) for every record
+*   - addChild									: adds a child key to parent key
+*   - deleteChild								: removes a child key from parent key
+*   - deleteRecord								: removes record and its key from its parents
+*   - copy										: DbCore holding a consistent image of the db
+*
+* Required Files:
+* ---------------
+* ConcurrentDbCore.h, DbCore.h, DbCore.cpp
+* DateTime.h, DateTime.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.2 : 18 Oct 2026
+* - copy stores records with DbCore::put, without handing out references
+* ver 1.1 : 18 Oct 2026
+* - put and insert enter the stored record's children in the parent
+*   index, and addChild and deleteChild lock both records' shards
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <algorithm>
+#include "DbCore.h"
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// ConcurrentDbCore class
+	// - shardCount must be a power of two
+	// - the parents of each key are kept in the key's own shard, as in
+	//   DbCore a superset of the true parents, so deleteRecord is
+	//   O(degree) rather than a scan of the whole db
+	// - children are entered there by put, insert, and addChild, but
+	//   not by update
+
+	template<typename T, size_t shardCount = 64>
+	class ConcurrentDbCore
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+
+		bool contains(const Key& key) const;
+		size_t size() const;
+		Keys keys() const;
+
+		DbElement<T> get(const Key& key) const;
+		bool find(const Key& key, DbElement<T>& elem) const;
+		void put(const Key& key, const DbElement<T>& elem);
+		bool insert(const Key& key, const DbElement<T>& elem);
+		template<typename F> bool read(const Key& key, F f) const;
+		template<typename F> bool update(const Key& key, F f);
+		template<typename F> void forEach(F f) const;
+
+		bool addChild(const Key& parentKey, const Key& childKey);
+		bool deleteChild(const Key& parentKey, const Key& childKey);
+		bool deleteRecord(const Key& key);
+
+		DbCore<T> copy() const;
+	private:
+		static_assert(shardCount > 0 && (shardCount & (shardCount - 1)) == 0, "shardCount must be a power of two");
+		using ReadLock = std::shared_lock<std::shared_timed_mutex>;
+		using WriteLock = std::unique_lock<std::shared_timed_mutex>;
+		using WriteLocks = std::vector<WriteLock>;
+
+		struct alignas(64) Shard
+		{
+			mutable std::shared_timed_mutex mutex;
+			std::unordered_map<Key, DbElement<T>> records;
+			std::unordered_map<Key, std::unordered_set<Key>> parents;
+		};
+
+		static size_t slot(const Key& key) { return std::hash<Key>()(key) & (shardCount - 1); }
+		Shard& shard(const Key& key) { return shards_[slot(key)]; }
+		const Shard& shard(const Key& key) const { return shards_[slot(key)]; }
+		WriteLocks lock(std::vector<size_t> slots);
+		WriteLocks lockWithChildren(const Key& key, const DbElement<T>& elem);
+		void addParent(const Key& key, const DbElement<T>& elem);
+
+		Shard shards_[shardCount];
+	};
+
+	//----< is key in db? >----------------------------------------------
+
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::contains(const Key& key) const
+	{
+		const Shard& s = shard(key);
+		ReadLock lock(s.mutex);
+		return s.records.find(key) != s.records.end();
+	}
+
+	//----< number of records, summed shard by shard >-------------------
+
+	template<typename T, size_t shardCount>
+	size_t ConcurrentDbCore<T, shardCount>::size() const
+	{
+		size_t count = 0;
+		for (const Shard& s : shards_)
+		{
+			ReadLock lock(s.mutex);
+			count += s.records.size();
+		}
+		return count;
+	}
+
+	//----< keys of all records >----------------------------------------
+
+	template<typename T, size_t shardCount>
+	typename ConcurrentDbCore<T, shardCount>::Keys ConcurrentDbCore<T, shardCount>::keys() const
+	{
+		Keys keys;
+		for (const Shard& s : shards_)
+		{
+			ReadLock lock(s.mutex);
+			for (const auto& item : s.records)
+				keys.push_back(item.first);
+		}
+		return keys;
+	}
+
+	//----< copy of record for key, throws if key is not in db >---------
+
+	template<typename T, size_t shardCount>
+	DbElement<T> ConcurrentDbCore<T, shardCount>::get(const Key& key) const
+	{
+		DbElement<T> elem;
+		if (!find(key, elem))
+			throw(std::exception("key does not exist in db"));
+		return elem;
+	}
+
+	//----< copy record for key into elem, false if key is not in db >---
+
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::find(const Key& key, DbElement<T>& elem) const
+	{
+		return read(key, [&elem](const DbElement<T>& record) { elem = record; });
+	}
+
+	//----< write-lock each shard in slots once, in shard order >--------
+
+	template<typename T, size_t shardCount>
+	typename ConcurrentDbCore<T, shardCount>::WriteLocks ConcurrentDbCore<T, shardCount>::lock(std::vector<size_t> slots)
+	{
+		std::sort(slots.begin(), slots.end());
+		slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+		WriteLocks locks;
+		locks.reserve(slots.size());
+		for (size_t i : slots)
+			locks.emplace_back(shards_[i].mutex);
+		return locks;
+	}
+
+	//----< write-lock the shards of key and of elem's children >--------
+
+	template<typename T, size_t shardCount>
+	typename ConcurrentDbCore<T, shardCount>::WriteLocks ConcurrentDbCore<T, shardCount>::lockWithChildren(const Key& key, const DbElement<T>& elem)
+	{
+		std::vector<size_t> slots;
+		slots.reserve(elem.children().size() + 1);
+		slots.push_back(slot(key));
+		for (const Key& child : elem.children())
+			slots.push_back(slot(child));
+		return lock(std::move(slots));
+	}
+
+	//----< enter key as a parent of each of elem's children >-----------
+	/*
+	*  - the caller holds the children's shard locks
+	*/
+	template<typename T, size_t shardCount>
+	void ConcurrentDbCore<T, shardCount>::addParent(const Key& key, const DbElement<T>& elem)
+	{
+		for (const Key& child : elem.children())
+			shard(child).parents[child].insert(key);
+	}
+
+	//----< insert or replace record for key >---------------------------
+
+	template<typename T, size_t shardCount>
+	void ConcurrentDbCore<T, shardCount>::put(const Key& key, const DbElement<T>& elem)
+	{
+		WriteLocks locks = lockWithChildren(key, elem);
+		shard(key).records[key] = elem;
+		addParent(key, elem);
+	}
+
+	//----< insert record for key, false if key is already in db >-------
+
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::insert(const Key& key, const DbElement<T>& elem)
+	{
+		WriteLocks locks = lockWithChildren(key, elem);
+		if (!shard(key).records.insert(std::make_pair(key, elem)).second)
+			return false;
+		addParent(key, elem);
+		return true;
+	}
+
+	//----< call f(const DbElement<T>&) on record for key >--------------
+	/*
+	*  - f runs under the shard's read lock, so it must not call back
+	*    into this db
+	*/
+	template<typename T, size_t shardCount>
+	template<typename F>
+	bool ConcurrentDbCore<T, shardCount>::read(const Key& key, F f) const
+	{
+		const Shard& s = shard(key);
+		ReadLock lock(s.mutex);
+		auto iter = s.records.find(key);
+		if (iter == s.records.end())
+			return false;
+		f(iter->second);
+		return true;
+	}
+
+	//----< call f(DbElement<T>&) on record for key, to edit it >--------
+	/*
+	*  - f runs under the shard's write lock, so it must not call back
+	*    into this db
+	*  - children added by f are not entered in the parent index; use
+	*    addChild for those
+	*/
+	template<typename T, size_t shardCount>
+	template<typename F>
+	bool ConcurrentDbCore<T, shardCount>::update(const Key& key, F f)
+	{
+		Shard& s = shard(key);
+		WriteLock lock(s.mutex);
+		auto iter = s.records.find(key);
+		if (iter == s.records.end())
+			return false;
+		f(iter->second);
+		return true;
+	}
+
+	//----< call f(key, const DbElement<T>&) for every record >----------
+	/*
+	*  - one shard is locked at a time, so records written meanwhile may
+	*    or may not be visited; use copy for a consistent image
+	*/
+	template<typename T, size_t shardCount>
+	template<typename F>
+	void ConcurrentDbCore<T, shardCount>::forEach(F f) const
+	{
+		for (const Shard& s : shards_)
+		{
+			ReadLock lock(s.mutex);
+			for (const auto& item : s.records)
+				f(item.first, item.second);
+		}
+	}
+
+	//----< add childKey to parentKey's children >-----------------------
+	/*
+	*  - both records must exist, as in DbCore::addChild
+	*  - both shards stay locked throughout, so the child cannot be
+	*    deleted between the check and the update
+	*/
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::addChild(const Key& parentKey, const Key& childKey)
+	{
+		WriteLocks locks = lock({ slot(parentKey), slot(childKey) });
+		Shard& c = shard(childKey);
+		if (c.records.find(childKey) == c.records.end())
+			return false;
+		Shard& p = shard(parentKey);
+		auto parent = p.records.find(parentKey);
+		if (parent == p.records.end())
+			return false;
+		parent->second.children().push_back(childKey);
+		c.parents[childKey].insert(parentKey);
+		return true;
+	}
+
+	//----< remove every occurrence of childKey from parentKey >---------
+
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::deleteChild(const Key& parentKey, const Key& childKey)
+	{
+		WriteLocks locks = lock({ slot(parentKey), slot(childKey) });
+		Shard& p = shard(parentKey);
+		auto parent = p.records.find(parentKey);
+		if (parent == p.records.end())
+			return false;
+		Keys& children = parent->second.children();
+		children.erase(std::remove(children.begin(), children.end(), childKey), children.end());
+		Shard& c = shard(childKey);
+		auto edges = c.parents.find(childKey);
+		if (edges != c.parents.end())
+			edges->second.erase(parentKey);
+		return true;
+	}
+
+	//----< remove record for key, and key from its parents' children >--
+	/*
+	*  - key leaves a child's parents only if no record for key, stored
+	*    again meanwhile, still lists that child
+	*/
+	template<typename T, size_t shardCount>
+	bool ConcurrentDbCore<T, shardCount>::deleteRecord(const Key& key)
+	{
+		Keys children;
+		std::unordered_set<Key> parents;
+		{
+			Shard& s = shard(key);
+			WriteLock lock(s.mutex);
+			auto iter = s.records.find(key);
+			if (iter == s.records.end())
+				return false;
+			children = iter->second.children();
+			s.records.erase(iter);
+			auto edges = s.parents.find(key);
+			if (edges != s.parents.end())
+			{
+				parents.swap(edges->second);
+				s.parents.erase(edges);
+			}
+		}
+		for (const Key& parentKey : parents)
+		{
+			update(parentKey, [&key](DbElement<T>& parent)
+			{
+				Keys& siblings = parent.children();
+				siblings.erase(std::remove(siblings.begin(), siblings.end(), key), siblings.end());
+			});
+		}
+		for (const Key& childKey : children)
+		{
+			WriteLocks locks = lock({ slot(key), slot(childKey) });
+			const Shard& s = shard(key);
+			auto record = s.records.find(key);
+			if (record != s.records.end())
+			{
+				const Keys& current = record->second.children();
+				if (std::find(current.begin(), current.end(), childKey) != current.end())
+					continue;
+			}
+			Shard& c = shard(childKey);
+			auto edges = c.parents.find(childKey);
+			if (edges != c.parents.end())
+				edges->second.erase(key);
+		}
+		return true;
+	}
+
+	//----< DbCore holding a consistent image of every shard >-----------
+	/*
+	*  - holds every shard's read lock while copying, taken in shard order
+	*/
+	template<typename T, size_t shardCount>
+	DbCore<T> ConcurrentDbCore<T, shardCount>::copy() const
+	{
+		std::vector<ReadLock> locks;
+		locks.reserve(shardCount);
+		for (const Shard& s : shards_)
+			locks.emplace_back(s.mutex);
+		DbCore<T> db;
+		size_t count = 0;
+		for (const Shard& s : shards_)
+			count += s.records.size();
+		db.reserve(count);
+		for (const Shard& s : shards_)
+			for (const auto& item : s.records)
+				db.put(item.first, item.second);
+		return db;
+	}
+}
+
+#endif
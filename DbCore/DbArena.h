@@ -0,0 +1,233 @@
+#pragma once
+#ifndef _DBARENA_H_
+#define _DBARENA_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// DbArena.h - per-database memory pool for DbCore record storage                  //
+// ver 1.1                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines two classes:
+* - DbArena carves small blocks out of large chunks, keeping a free
+*   list per size class so freed blocks are reused by the next block
+*   of the same size.  Taking n blocks of one size costs about
+*   n * blockSize / chunkBytes chunk allocations, not n, and the
+*   chunks are all freed at once when the arena goes away.
+* - ArenaAllocator<U> is a standard allocator that takes its memory
+*   from a DbArena, or from operator new if it has none.  It holds a
+*   shared_ptr to its arena, so an arena lives as long as any container
+*   still using it.
+*
+* DbCore stores its records with an ArenaAllocator, so a DbCore built
+* with an arena takes each record's hash-table node from the arena: the
+* key and DbElement objects, and any strings short enough to be held
+* inside them.  That is one heap allocation saved per record, not all
+* of them.  The allocator is not passed on to what a record owns: its
+* longer strings, its children vector and its payload's file path and
+* categories still come from the heap, one allocation each, and are
+* freed one at a time.  Bucket arrays larger than maxPooled, all but
+* the smallest, come from the heap too.
+*
+* Like DbCore, a DbArena is not thread safe: use it from one thread, or
+* guard it as the db is guarded.
+*
+*   ----------------------------------------------------------
+*   - allocate, deallocate						: take and return a block
+*   - release									: free every chunk at once
+*   - chunks									: number of chunks held
+*   - bytesReserved							: bytes held in chunks
+*
+* Required Files:
+* ---------------
+* DbArena.h
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.1 : 18 Oct 2026
+* - documented that only record nodes come from the arena
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// DbArena class
+	// - blocks are rounded up to a multiple of alignment; blocks larger
+	//   than maxPooled go straight to operator new and delete
+	// - release frees every chunk, so it may only be called when no
+	//   block taken from the arena is still in use
+
+	class DbArena
+	{
+	public:
+		static const size_t alignment = 16;
+		static const size_t maxPooled = 512;
+
+		explicit DbArena(size_t chunkBytes = 64 * 1024);
+		DbArena(const DbArena&) = delete;
+		DbArena& operator=(const DbArena&) = delete;
+		~DbArena() { release(); }
+
+		void* allocate(size_t bytes);
+		void deallocate(void* block, size_t bytes);
+		void release();
+		size_t chunks() const { return chunks_.size(); }
+		size_t bytesReserved() const { return chunks_.size() * chunkBytes_; }
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+		static const size_t classes = maxPooled / alignment;
+
+		static size_t sizeClass(size_t bytes) { return (bytes + alignment - 1) / alignment - 1; }
+
+		size_t chunkBytes_;
+		std::vector<char*> chunks_;
+		char* next_ = nullptr;
+		char* end_ = nullptr;
+		FreeBlock* free_[classes];
+	};
+
+	//----< arena that takes memory chunkBytes at a time >---------------
+
+	inline DbArena::DbArena(size_t chunkBytes)
+		: chunkBytes_(chunkBytes < maxPooled ? maxPooled : chunkBytes)
+	{
+		for (size_t i = 0; i < classes; ++i)
+			free_[i] = nullptr;
+	}
+
+	//----< take a block from its size class, else from the chunk >------
+
+	inline void* DbArena::allocate(size_t bytes)
+	{
+		if (bytes == 0)
+			bytes = 1;
+		if (bytes > maxPooled)
+			return ::operator new(bytes);
+		size_t cls = sizeClass(bytes);
+		if (free_[cls] != nullptr)
+		{
+			FreeBlock* block = free_[cls];
+			free_[cls] = block->next;
+			return block;
+		}
+		size_t size = (cls + 1) * alignment;
+		if (static_cast<size_t>(end_ - next_) < size)
+		{
+			next_ = static_cast<char*>(::operator new(chunkBytes_));
+			end_ = next_ + chunkBytes_;
+			chunks_.push_back(next_);
+		}
+		void* block = next_;
+		next_ += size;
+		return block;
+	}
+
+	//----< return a block to its size class for reuse >-----------------
+
+	inline void DbArena::deallocate(void* block, size_t bytes)
+	{
+		if (block == nullptr)
+			return;
+		if (bytes == 0)
+			bytes = 1;
+		if (bytes > maxPooled)
+		{
+			::operator delete(block);
+			return;
+		}
+		size_t cls = sizeClass(bytes);
+		FreeBlock* freed = static_cast<FreeBlock*>(block);
+		freed->next = free_[cls];
+		free_[cls] = freed;
+	}
+
+	//----< free every chunk at once >-----------------------------------
+
+	inline void DbArena::release()
+	{
+		for (char* chunk : chunks_)
+			::operator delete(chunk);
+		chunks_.clear();
+		next_ = end_ = nullptr;
+		for (size_t i = 0; i < classes; ++i)
+			free_[i] = nullptr;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// ArenaAllocator class
+	// - allocators compare equal when they share an arena
+	// - a copied container gets no arena, as std::pmr containers get
+	//   the default resource, so copies never tie two dbs to one arena
+
+	template<typename U>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = U;
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::false_type;
+		using propagate_on_container_swap = std::false_type;
+
+		ArenaAllocator() noexcept {}
+		ArenaAllocator(std::shared_ptr<DbArena> arena) noexcept : arena_(std::move(arena)) {}
+		template<typename V>
+		ArenaAllocator(const ArenaAllocator<V>& alloc) noexcept : arena_(alloc.arena()) {}
+
+		U* allocate(size_t count);
+		void deallocate(U* block, size_t count);
+		ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+		const std::shared_ptr<DbArena>& arena() const { return arena_; }
+	private:
+		static_assert(alignof(U) <= DbArena::alignment, "type is aligned more strictly than DbArena blocks");
+		std::shared_ptr<DbArena> arena_;
+	};
+
+	//----< take count U's worth of memory >-----------------------------
+
+	template<typename U>
+	U* ArenaAllocator<U>::allocate(size_t count)
+	{
+		if (arena_)
+			return static_cast<U*>(arena_->allocate(count * sizeof(U)));
+		return static_cast<U*>(::operator new(count * sizeof(U)));
+	}
+
+	//----< return memory taken by allocate(count) >---------------------
+
+	template<typename U>
+	void ArenaAllocator<U>::deallocate(U* block, size_t count)
+	{
+		if (arena_)
+			arena_->deallocate(block, count * sizeof(U));
+		else
+			::operator delete(block);
+	}
+
+	template<typename U, typename V>
+	bool operator==(const ArenaAllocator<U>& a, const ArenaAllocator<V>& b) { return a.arena() == b.arena(); }
+
+	template<typename U, typename V>
+	bool operator!=(const ArenaAllocator<U>& a, const ArenaAllocator<V>& b) { return !(a == b); }
+}
+
+#endif
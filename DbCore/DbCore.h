@@ -3,7 +3,7 @@
 #define _TESTDBCORE_H_
 /////////////////////////////////////////////////////////////////////////////////////
 // DbCore.h - Implements NoSql database prototype								   //
-// ver 1.0                                                                         //
+// ver 1.11                                                                        //
 //                                                                                 //
 // Environment : C++ Console Application                                           //
 // Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
@@ -50,11 +50,68 @@ Database operations
 without deleting the record from the db
 *   - getFiles									: finds all the files, matching pattern, in the entire directory tree rooted at repo.storagePath.
 *   - getFilesHelper							: private helper function for getFiles function
+*   - indexing									: turns the optional secondary indexes on or off
+*   - index										: returns the secondary indexes, brought up to date
+*   - since										: returns a TimeCursor over records written after a time
+*   - parents									: returns keys of all records that list a key as a child
+*   - descendants								: returns keys of all records reachable through children
+*   - id, key									: translate between a key in use and its internal record id
+*   - arena, reserve							: the db's record arena, and room for more records
+*   - put										: moves or copies a record into db, replacing any with its key
+*   - load										: moves or copies a batch of records into db at once
+*   - emplace									: constructs a record in place if its key is new
+*
+* A DbCore constructed with a DbArena (DbArena.h) takes the hash-table
+* node of each record - its key and DbElement - from that arena, a chunk
+* at a time, instead of making one heap allocation per record.  What a
+* record owns - longer names and descriptions, children, the payload's
+* file path and categories - is still allocated from the heap, and freed
+* piece by piece when the db goes away.  Default-constructed and copied
+* dbs use the heap for everything.
+*
+* DbCore interns every key it sees into a dense RecordId (KeyTable.h)
+* and keeps the relationship graph as vectors of ids: each record's
+* distinct children, and the reverse index from each child to the
+* records that list it, so deleteRecord visits only the records that
+* reference the deleted key and traversals never hash a string.  The
+* graph is brought up to date from the records' children, by the same
+* dirty key tracking as the indexes, before it is read.  Children and
+* query results are still handed out as keys.
+*
+* The graph is an index kept beside the records, not a replacement for
+* their children: it costs memory, a second copy of each key in the
+* KeyTable and a few ids per edge, to make relationship operations fast.
+* A key's id is released once no record has the key or lists it as a
+* child, and is then reused for the next new key, so the table holds
+* only keys in use, however many records come and go.
+*
+* TimeCursor reads keys in dateTime order, a batch at a time, from the
+* time index.  Each batch costs O(log N + batch size).  Records that are
+* added later with newer times are returned by later batches.
+*
+* Secondary indexes are off by default.  When on, records changed by
+* DbCore's own mutators are reindexed the next time index() is called.
+* Keys handed out through non-const operator[] or emplace are marked
+* dirty too, and non-const begin(), end() or dbStore() mark every
+* record, so edits made through the reference are seen by the next
+* index() call, and the next read of the graph, which compare each
+* dirty record with what was indexed for it.  That read clears the
+* mark: to edit the record again after it, take the reference again.
+* Use put or load to store records without handing out a reference,
+* and the const overloads to read them.
+*
+* index() is const but brings the index up to date, so it holds a lock
+* while it does: several threads may read a db that none of them
+* changes, through index() and the other const methods, and the first
+* to call index() refreshes it while the others wait.  Changing the db
+* while other threads read it still needs the caller's own locking, or
+* a ConcurrentDbCore.
 *
 
 * Required Files:
 * ---------------
 * DbCore.h, DbCore.cpp
+* DbIndex.h, KeyTable.h, DbArena.h
 * DateTime.h, DateTime.cpp
 * StringUtilities.h, StringUtilities.cpp
 * TestUtilities.h, TestUtilities.cpp
@@ -65,15 +122,55 @@ without deleting the record from the db
 *
 * Maintenance History:
 * --------------------
+* ver 1.11 : 18 Oct 2026
+* - index() holds a lock while it brings the index up to date, so
+*   threads sharing an unchanging db may all call it
+* ver 1.10 : 18 Oct 2026
+* - keys handed out by reference are marked dirty until the next read
+*   only, so index() and graph reads no longer recheck every record
+*   once many keys have been handed out
+* - put stores a record without handing out a reference
+* ver 1.9 : 18 Oct 2026
+* - ids of keys no longer in use are released for reuse
+* - documented that a DbArena holds record nodes only
+* ver 1.8 : 18 Oct 2026
+* - DbElement and dbStore const getters return references, setters
+*   move; emplace; showDb and showRecord read records without copying
+* ver 1.7 : 18 Oct 2026
+* - load, for bulk inserts
+* ver 1.6 : 18 Oct 2026
+* - records may be stored in a per-database DbArena; reserve
+* ver 1.5 : 18 Oct 2026
+* - keys interned as record ids; child and parent edges held as id
+*   vectors, kept exact instead of pruned when visited; descendants
+* ver 1.4 : 18 Oct 2026
+* - reverse child-to-parent index; deleteRecord and deleteChild no longer
+*   scan the whole db
+* ver 1.3 : 18 Oct 2026
+* - TimeCursor for incremental reads of records written since a time
+* ver 1.2 : 18 Oct 2026
+* - optional secondary indexes on name, category, dateTime, and description
+* ver 1.1 : 18 Oct 2026
+* - const overloads of keys, contains, size, begin and end; const
+*   operator[] returns a reference instead of a copy
 * ver 1.0 : 5 Feb 2018
 */
 
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
+#include <mutex>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <tuple>
 #include "../DateTime/DateTime.h"
+#include "DbIndex.h"
+#include "KeyTable.h"
+#include "DbArena.h"
 
 namespace NoSqlDb
 {
@@ -89,27 +186,33 @@ namespace NoSqlDb
 		using Key = std::string;
 		using Children = std::vector<Key>;
 
+		DbElement() = default;
+		DbElement(std::string name, std::string descrip, T payLoad = T())
+			: name_(std::move(name)), descrip_(std::move(descrip)), payLoad_(std::move(payLoad)) {}
+
 		// methods to get and set DbElement fields
+		// - const getters return references, so reading a record never copies it
+		// - setters take their argument by value, so a temporary is moved in
 
 		std::string& name() { return name_; }
-		std::string name() const { return name_; }
-		void name(const std::string& name) { name_ = name; }
+		const std::string& name() const { return name_; }
+		void name(std::string name) { name_ = std::move(name); }
 
 		std::string& descrip() { return descrip_; }
-		std::string descrip() const { return descrip_; }
-		void descrip(const std::string& name) { descrip_ = name; }
+		const std::string& descrip() const { return descrip_; }
+		void descrip(std::string name) { descrip_ = std::move(name); }
 
 		DateTime& dateTime() { return dateTime_; }
 		DateTime dateTime() const { return dateTime_; }
 		void dateTime(const DateTime& dateTime) { dateTime_ = dateTime; }
 
 		Children& children() { return children_; }
-		Children children() const { return children_; }
-		void children(const Children& children) { children_ = children; }
+		const Children& children() const { return children_; }
+		void children(Children children) { children_ = std::move(children); }
 
 		T& payLoad() { return payLoad_; }
-		T payLoad() const { return payLoad_; }
-		void payLoad(const T& payLoad) { payLoad_ = payLoad; }
+		const T& payLoad() const { return payLoad_; }
+		void payLoad(T payLoad) { payLoad_ = std::move(payLoad); }
 
 	private:
 		std::string name_;
@@ -119,6 +222,8 @@ namespace NoSqlDb
 		T payLoad_;
 	};
 
+	template <typename T> class TimeCursor;
+
 	/////////////////////////////////////////////////////////////////////
 	// DbCore class
 	// - provides core NoSql db operations
@@ -132,32 +237,109 @@ namespace NoSqlDb
 		using Key = std::string;
 		using Keys = std::vector<Key>;
 		using Children = Keys;
-		using DbStore = std::unordered_map<Key, DbElement<T>>;
+		using Record = std::pair<Key, DbElement<T>>;
+		using Records = std::vector<Record>;
+		using Allocator = ArenaAllocator<std::pair<const Key, DbElement<T>>>;
+		using DbStore = std::unordered_map<Key, DbElement<T>, std::hash<Key>, std::equal_to<Key>, Allocator>;
 		using iterator = typename DbStore::iterator;
+		using const_iterator = typename DbStore::const_iterator;
+
+		DbCore() {}
+		explicit DbCore(std::shared_ptr<DbArena> arena)
+			: dbStore_(0, std::hash<Key>(), std::equal_to<Key>(), Allocator(std::move(arena))) {}
 
 		// methods to access database elements
 
-		Keys keys(); // return all keys in db
-		bool contains(const Key& key);
-		size_t size();
+		Keys keys() const; // return all keys in db
+		bool contains(const Key& key) const;
+		size_t size() const;
 		void throwOnIndexNotFound(bool doThrow) { doThrow_ = doThrow; }
 		DbElement<T>& operator[](const Key& key);
-		DbElement<T> operator[](const Key& key) const;
-		typename iterator begin() { return dbStore_.begin(); }
-		typename iterator end() { return dbStore_.end(); }
+		const DbElement<T>& operator[](const Key& key) const;
+		typename iterator begin() { touchAll(); return dbStore_.begin(); }
+		typename iterator end() { touchAll(); return dbStore_.end(); }
+		const_iterator begin() const { return dbStore_.begin(); }
+		const_iterator end() const { return dbStore_.end(); }
 		bool addChild(const Key& parentKey, const Key& childKey);
 		bool deleteRecord(const Key& key);
 		bool deleteChild(const Key& parentKey, const Key& childKey);
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Key key, Args&&... args);
+		void put(Key key, DbElement<T> elem);
+		template<typename Iter>
+		Keys load(Iter first, Iter last);
+		Keys load(Records&& records) { return load(std::make_move_iterator(records.begin()), std::make_move_iterator(records.end())); }
+		Keys parents(const Key& childKey);
+		Keys descendants(const Key& key);
+		RecordId id(const Key& key) const { return ids_.find(key); }
+		const Key& key(RecordId id) const { return ids_.key(id); }
 
 		// methods to get and set the private database hash-map storage
 
-		DbStore& dbStore() { return dbStore_; }
-		DbStore dbStore() const { return dbStore_; }
-		void dbStore(const DbStore& dbStore) { dbStore_ = dbStore; }
+		DbStore& dbStore() { touchAll(); return dbStore_; }
+		const DbStore& dbStore() const { return dbStore_; }
+		void dbStore(const DbStore& dbStore);
+		void dbStore(DbStore&& dbStore);
+		std::shared_ptr<DbArena> arena() const { return dbStore_.get_allocator().arena(); }
+		void reserve(size_t count) { dbStore_.reserve(count); }
+
+		// methods to manage the optional secondary indexes
+
+		void indexing(bool on);
+		bool indexing() const { return indexing_; }
+		const DbIndex<T>& index() const;
+		TimeCursor<T> since(DateTime dateTime) const;
 
 	private:
+		using Ids = std::vector<RecordId>;
+
+		struct IndexLock  // a mutex that copies of the db do not share
+		{
+			IndexLock() {}
+			IndexLock(const IndexLock&) {}
+			IndexLock& operator=(const IndexLock&) { return *this; }
+			std::mutex mutex;
+		};
+
+		void touch(const Key& key);
+		void touchAll();
+		void syncEdges();
+		void relink(RecordId parent, const Children* children);
+		void releaseIfUnused(RecordId id);
+		static void eraseId(Ids& ids, RecordId id);
+		static bool removeKey(Keys& keys, const Key& key, bool all);
+
 		DbStore dbStore_;
 		bool doThrow_ = false;
+		bool indexing_ = false;
+		mutable DbIndex<T> index_;
+		mutable std::unordered_set<Key> dirty_;  // keys that may have changed since last indexed
+		mutable bool stale_ = false;              // true if every key must be reindexed
+		mutable IndexLock indexLock_;             // held while index() brings the index up to date
+		KeyTable ids_;
+		std::vector<Ids> children_;               // record id -> sorted, distinct child ids
+		std::vector<Ids> parents_;                // child id -> ids of records listing it
+		std::unordered_set<RecordId> edgesDirty_; // records whose children may have changed
+		bool edgesStale_ = false;                 // true if the graph must be rebuilt
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	// TimeCursor class
+	// - reads keys of records in dateTime order, starting after a time
+	// - requires the db's secondary indexes to be turned on
+
+	template <typename T>
+	class TimeCursor
+	{
+	public:
+		using Keys = typename DbIndex<T>::Keys;
+
+		TimeCursor(const DbCore<T>& db, size_t afterTicks) : db_(db), pos_(afterTicks, "") {}
+		Keys next(size_t count = 1) { return db_.index().byTimeFrom(pos_, count); }
+
+	private:
+		const DbCore<T>& db_;
+		typename DbIndex<T>::TimePos pos_;
 	};
 
 	/////////////////////////////////////////////////////////////////////
@@ -166,22 +348,22 @@ namespace NoSqlDb
 	//----< does db contain this key? >----------------------------------
 
 	template<typename T>
-	bool DbCore<T>::contains(const Key& key)
+	bool DbCore<T>::contains(const Key& key) const
 	{
-		iterator iter = dbStore_.find(key);
+		const_iterator iter = dbStore_.find(key);
 		return iter != dbStore_.end();
 	}
 
 	//----< returns current key set for db >-----------------------------
 
 	template<typename T>
-	typename DbCore<T>::Keys DbCore<T>::keys()
+	typename DbCore<T>::Keys DbCore<T>::keys() const
 	{
 		DbCore<T>::Keys dbKeys;
-		DbStore& dbs = dbStore();
+		const DbStore& dbs = dbStore_;
 		size_t size = dbs.size();
 		dbKeys.reserve(size);
-		for (auto item : dbs)
+		for (const auto& item : dbs)  // note const auto& - we don't want a copy of each record
 		{
 			dbKeys.push_back(item.first);
 		}
@@ -191,7 +373,7 @@ namespace NoSqlDb
 	//----< return number of db elements >-------------------------------
 
 	template<typename T>
-	size_t DbCore<T>::size()
+	size_t DbCore<T>::size() const
 	{
 		return dbStore_.size();
 	}
@@ -213,6 +395,7 @@ namespace NoSqlDb
 	template<typename T>
 	DbElement<T>& DbCore<T>::operator[](const Key& key)
 	{
+		touch(key);
 		if (!contains(key))
 		{
 			if (doThrow_)
@@ -226,16 +409,390 @@ namespace NoSqlDb
 	//----< extracts value from db with key >----------------------------
 	/*
 	*  - indexes const db objects
+	*  - returns a reference into the store, so readers such as Query
+	*    can inspect records without copying them
 	*/
 
 	template<typename T>
-	DbElement<T> DbCore<T>::operator[](const Key& key) const
+	const DbElement<T>& DbCore<T>::operator[](const Key& key) const
 	{
-		if (!contains(key))
+		const_iterator iter = dbStore_.find(key);
+		if (iter == dbStore_.end())
 		{
 			throw(std::exception("key does not exist in db"));
 		}
-		return dbStore_[key];
+		return iter->second;
+	}
+
+	//----< remember that key's record may be edited by the caller >----
+	/*
+	*  - once more than half the db is dirty a full rebuild is cheaper
+	*    than tracking each key, so the whole index is marked stale
+	*/
+
+	template<typename T>
+	void DbCore<T>::touch(const Key& key)
+	{
+		if (indexing_ && !stale_)
+		{
+			dirty_.insert(key);
+			if (dirty_.size() > dbStore_.size() / 2 + 64)
+				touchAll();
+		}
+		if (!edgesStale_)
+		{
+			edgesDirty_.insert(ids_.intern(key));
+			if (edgesDirty_.size() > dbStore_.size() / 2 + 64)
+				touchAll();
+		}
+	}
+
+	//----< remember that any record may be edited by the caller >-------
+
+	template<typename T>
+	void DbCore<T>::touchAll()
+	{
+		if (indexing_)
+		{
+			stale_ = true;
+			dirty_.clear();
+		}
+		edgesStale_ = true;
+		edgesDirty_.clear();
+	}
+
+	//----< replace the whole store >------------------------------------
+
+	template<typename T>
+	void DbCore<T>::dbStore(const DbStore& dbStore)
+	{
+		touchAll();
+		dbStore_ = dbStore;
+	}
+
+	template<typename T>
+	void DbCore<T>::dbStore(DbStore&& dbStore)
+	{
+		touchAll();
+		dbStore_ = std::move(dbStore);
+	}
+
+	//----< brings the id graph up to date with the records' children >-
+
+	template<typename T>
+	void DbCore<T>::syncEdges()
+	{
+		if (edgesStale_)
+		{
+			ids_ = KeyTable();  // ids of keys no longer in use are dropped
+			children_.clear();
+			parents_.clear();
+			for (const auto& item : dbStore_)
+				relink(ids_.intern(item.first), &item.second.children());
+			edgesStale_ = false;
+		}
+		else
+		{
+			for (RecordId id : edgesDirty_)
+			{
+				if (ids_.find(ids_.key(id)) != id)
+					continue;  // released while relinking another record
+				iterator iter = dbStore_.find(ids_.key(id));
+				if (iter == dbStore_.end())
+				{
+					relink(id, nullptr);
+					releaseIfUnused(id);
+				}
+				else
+					relink(id, &iter->second.children());
+			}
+		}
+		edgesDirty_.clear();
+	}
+
+	//----< make parent's edges those of children, null for none >------
+	/*
+	*  - diffs the old and new sorted child ids, so only edges that were
+	*    added or removed touch the reverse index
+	*/
+
+	template<typename T>
+	void DbCore<T>::relink(RecordId parent, const Children* children)
+	{
+		Ids now;
+		if (children != nullptr)
+		{
+			now.reserve(children->size());
+			for (const Key& child : *children)
+				now.push_back(ids_.intern(child));
+			std::sort(now.begin(), now.end());
+			now.erase(std::unique(now.begin(), now.end()), now.end());
+		}
+		if (children_.size() < ids_.size())
+		{
+			children_.resize(ids_.size());
+			parents_.resize(ids_.size());
+		}
+		Ids& was = children_[parent];
+		Ids orphans;  // children that lost their last parent
+		size_t i = 0, j = 0;
+		while (i < was.size() || j < now.size())
+		{
+			if (j == now.size() || (i < was.size() && was[i] < now[j]))
+			{
+				Ids& parents = parents_[was[i]];
+				eraseId(parents, parent);
+				if (parents.empty())
+					orphans.push_back(was[i]);
+				++i;
+			}
+			else if (i == was.size() || now[j] < was[i])
+				parents_[now[j++]].push_back(parent);
+			else
+			{
+				++i;
+				++j;
+			}
+		}
+		was.swap(now);
+		for (RecordId orphan : orphans)
+			releaseIfUnused(orphan);
+	}
+
+	//----< releases id if no record has its key or lists it as a child >
+
+	template<typename T>
+	void DbCore<T>::releaseIfUnused(RecordId id)
+	{
+		if (parents_[id].empty() && children_[id].empty() && dbStore_.find(ids_.key(id)) == dbStore_.end())
+			ids_.release(id);
+	}
+
+	//----< removes id from an unordered id vector >---------------------
+
+	template<typename T>
+	void DbCore<T>::eraseId(Ids& ids, RecordId id)
+	{
+		typename Ids::iterator iter = std::find(ids.begin(), ids.end(), id);
+		if (iter == ids.end())
+			return;
+		*iter = ids.back();
+		ids.pop_back();
+	}
+
+	//----< removes first, or every, occurrence of key from keys >-------
+
+	template<typename T>
+	bool DbCore<T>::removeKey(Keys& keys, const Key& key, bool all)
+	{
+		if (all)
+		{
+			size_t size = keys.size();
+			keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+			return keys.size() != size;
+		}
+		typename Keys::iterator iter = std::find(keys.begin(), keys.end(), key);
+		if (iter == keys.end())
+			return false;
+		keys.erase(iter);
+		return true;
+	}
+
+	//----< returns keys of all records that list childKey as a child >--
+
+	template<typename T>
+	typename DbCore<T>::Keys DbCore<T>::parents(const Key& childKey)
+	{
+		syncEdges();
+		Keys result;
+		RecordId child = ids_.find(childKey);
+		if (child == KeyTable::npos || child >= parents_.size())
+			return result;
+		result.reserve(parents_[child].size());
+		for (RecordId parent : parents_[child])
+			result.push_back(ids_.key(parent));
+		return result;
+	}
+
+	//----< returns keys of all records reachable from key's children >-
+	/*
+	*  - walks the id graph, so each edge costs a vector read, not a hash
+	*  - child keys that name no record are not returned
+	*  - key itself is not returned, even when a cycle leads back to it
+	*/
+
+	template<typename T>
+	typename DbCore<T>::Keys DbCore<T>::descendants(const Key& key)
+	{
+		syncEdges();
+		Keys result;
+		RecordId start = ids_.find(key);
+		if (start == KeyTable::npos || start >= children_.size())
+			return result;
+		std::vector<bool> seen(children_.size(), false);
+		Ids pending(1, start);
+		seen[start] = true;
+		while (!pending.empty())
+		{
+			RecordId id = pending.back();
+			pending.pop_back();
+			for (RecordId child : children_[id])
+			{
+				if (seen[child])
+					continue;
+				seen[child] = true;
+				pending.push_back(child);
+				if (dbStore_.find(ids_.key(child)) != dbStore_.end())
+					result.push_back(ids_.key(child));
+			}
+		}
+		return result;
+	}
+
+	//----< turns the secondary indexes on or off >----------------------
+	/*
+	*  - turning them on is cheap; they are built by the next index() call
+	*/
+
+	template<typename T>
+	void DbCore<T>::indexing(bool on)
+	{
+		indexing_ = on;
+		index_.clear();
+		dirty_.clear();
+		stale_ = on;
+	}
+
+	//----< returns secondary indexes, after reindexing changed keys >---
+	/*
+	*  - dirty keys are refreshed, so a record handed out by reference
+	*    but not edited is only compared with its entry, and then are
+	*    forgotten until they are touched again
+	*  - holds indexLock_, so concurrent readers refresh the index once
+	*/
+
+	template<typename T>
+	const DbIndex<T>& DbCore<T>::index() const
+	{
+		if (!indexing_)
+			return index_;
+		std::lock_guard<std::mutex> lock(indexLock_.mutex);
+		if (!stale_)
+		{
+			for (const Key& key : dirty_)
+			{
+				const_iterator iter = dbStore_.find(key);
+				if (iter == dbStore_.end())
+					index_.unindex(key);
+				else
+					index_.refresh(key, iter->second);
+			}
+		}
+		if (stale_)
+		{
+			index_.clear();
+			for (const auto& item : dbStore_)
+				index_.index(item.first, item.second);
+			stale_ = false;
+		}
+		dirty_.clear();
+		return index_;
+	}
+
+	//----< constructs a record from args in place, unless key is in db >
+	/*
+	*  - like std::unordered_map::emplace: returns the record for key and
+	*    whether it was inserted; an existing record is left unchanged
+	*/
+	template<typename T>
+	template<typename... Args>
+	std::pair<typename DbCore<T>::iterator, bool> DbCore<T>::emplace(Key key, Args&&... args)
+	{
+		touch(key);  // the caller may edit the record through the iterator
+		iterator iter = dbStore_.find(key);
+		if (iter != dbStore_.end())
+			return std::make_pair(iter, false);
+		return dbStore_.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	//----< puts a record into db, replacing any with the same key >-----
+	/*
+	*  - hands out no reference, so the record is marked dirty for the
+	*    next read only; elem is moved in, not copied twice as it would be
+	*    by assigning through operator[]
+	*/
+	template<typename T>
+	void DbCore<T>::put(Key key, DbElement<T> elem)
+	{
+		touch(key);
+		iterator iter = dbStore_.find(key);
+		if (iter == dbStore_.end())
+			dbStore_.emplace(std::move(key), std::move(elem));
+		else
+			iter->second = std::move(elem);
+	}
+
+	//----< puts a batch of records into db, replacing any with the same key >
+	/*
+	*  - Iter is a forward iterator over Records; records are moved in
+	*    through move iterators, or by load(Records&&), else copied
+	*  - reserves buckets once, and skips the default-constructed element
+	*    and the second lookup that operator[] costs each record
+	*  - children are checked once the whole batch is in, so a record may
+	*    name a child that comes later in the batch
+	*  - returns sorted keys of loaded records with a child naming no record
+	*/
+	template<typename T>
+	template<typename Iter>
+	typename DbCore<T>::Keys DbCore<T>::load(Iter first, Iter last)
+	{
+		size_t count = static_cast<size_t>(std::distance(first, last));
+		dbStore_.reserve(dbStore_.size() + count);
+		bool rebuild = count > (dbStore_.size() + count) / 2;  // cheaper than tracking each key
+		if (rebuild)
+			touchAll();
+		std::vector<const typename DbStore::value_type*> loaded;
+		loaded.reserve(count);
+		for (; first != last; ++first)
+		{
+			auto&& record = *first;
+			using Ref = decltype(record);
+			if (!rebuild)
+				touch(record.first);
+			iterator iter = dbStore_.find(record.first);
+			if (iter == dbStore_.end())
+				iter = dbStore_.emplace(std::forward<Ref>(record).first, std::forward<Ref>(record).second).first;
+			else
+				iter->second = std::forward<Ref>(record).second;
+			loaded.push_back(&*iter);
+		}
+
+		Keys dangling;
+		for (auto record : loaded)
+		{
+			for (const Key& child : record->second.children())
+			{
+				if (dbStore_.find(child) == dbStore_.end())
+				{
+					dangling.push_back(record->first);
+					break;
+				}
+			}
+		}
+		std::sort(dangling.begin(), dangling.end());
+		dangling.erase(std::unique(dangling.begin(), dangling.end()), dangling.end());
+		return dangling;
+	}
+
+	//----< returns cursor over records written after dateTime >--------
+
+	template<typename T>
+	TimeCursor<T> DbCore<T>::since(DateTime dateTime) const
+	{
+		if (!indexing_)
+			throw(std::exception("since requires db indexing"));
+		return TimeCursor<T>(*this, dateTime.ticks());
 	}
 
 	/////////////////////////////////////////////////////////////////////
@@ -281,7 +838,7 @@ namespace NoSqlDb
 		out << std::setw(26) << std::left << std::string(el.dateTime());
 		out << std::setw(30) << std::left << el.descrip().substr(0, 28);
 		out << std::setw(25) << std::left << std::string(el.payLoad()).substr(0, 22);
-		typename DbElement<P>::Children children = el.children();
+		const typename DbElement<P>::Children& children = el.children();
 		if (children.size() > 0)
 		{
 			out << "\n    child keys: ";
@@ -301,7 +858,7 @@ namespace NoSqlDb
 		out << std::setw(26) << std::left << std::string(el.dateTime());
 		out << std::setw(30) << std::left << el.descrip().substr(0, 28);
 		out << std::setw(25) << std::left << std::string(el.payLoad()).substr(0, 24);
-		typename DbElement<P>::Children children = el.children();
+		const typename DbElement<P>::Children& children = el.children();
 		if (children.size() > 0)
 		{
 			out << "\n    child keys: ";
@@ -319,8 +876,7 @@ namespace NoSqlDb
 	void showDb(const DbCore<T>& db, std::ostream& out = std::cout)
 	{
 		showHeader(true, out);
-		typename DbCore<T>::DbStore dbs = db.dbStore();
-		for (auto item : dbs)
+		for (const auto& item : db.dbStore())
 		{
 			showRecord(item.first, item.second, out);
 		}
@@ -336,38 +892,45 @@ namespace NoSqlDb
 			return false;
 		DbElement<T>& el = dbStore_[parentKey];
 		el.children().push_back(childKey);
+		if (!edgesStale_)
+			edgesDirty_.insert(ids_.intern(parentKey));
 		return true;
 	}
 
 	/*----< delete the key/value pair associated with the key (deletion of key/value pairs)
 	by removing the record from the db >------------------*/
+	/*
+	*  - visits only the records the graph lists as parents of key
+	*/
 
 	template <typename T>
 	bool DbCore<T>::deleteRecord(const Key& key)
 	{
 		std::cout << "\n\n  Deleting a db element with key \"" << key << "\":";
-		if (dbStore_.find(key) == dbStore_.end())
+		iterator record = dbStore_.find(key);
+		if (record == dbStore_.end())
 			return false;
-		size_t numErased = dbStore_.erase(key);
-		if (numErased == 1)
+		dbStore_.erase(record);
+		if (indexing_)
 		{
-			// remove key from all other element's children collections
-			for (Key k : keys())
-			{
-				Keys& children = dbStore_[k].children();  // note Keys& - we don't want a copy of children
-				Keys::iterator iter;
-				for (iter = children.begin(); iter != children.end(); ++iter)
-				{
-					if ((*iter) == key)
-					{
-						children.erase(iter);
-						break;
-					}
-				}
-			}
-			return true;
+			index_.unindex(key);
+			dirty_.erase(key);
+		}
+		syncEdges();
+		RecordId id = ids_.intern(key);
+		relink(id, nullptr);  // the deleted record no longer parents its children
+		// remove key from the children collections of records that list it
+		Ids parentIds;
+		parentIds.swap(parents_[id]);
+		for (RecordId parentId : parentIds)
+		{
+			iterator parent = dbStore_.find(ids_.key(parentId));
+			if (parent != dbStore_.end())
+				removeKey(parent->second.children(), key, true);  // note: no copy of children
+			eraseId(children_[parentId], id);
 		}
-		return false;
+		releaseIfUnused(id);
+		return true;
 	}
 
 	/*----< delete all children associated with the key (deletion of relationships)
@@ -377,24 +940,13 @@ namespace NoSqlDb
 	bool DbCore<T>::deleteChild(const Key& parentKey, const Key& childKey)
 	{
 		std::cout << "\n\n  Deleting a db element with key \"" << childKey << "\" from \"" << parentKey << "\" :\n";
-		if (dbStore_.find(parentKey) == dbStore_.end())
+		iterator parent = dbStore_.find(parentKey);
+		if (parent == dbStore_.end())
 			return false;
-		for (Key k : keys())
-		{
-			if (k == parentKey)
-			{
-				Keys& children = dbStore_[k].children();  // note Keys& - we don't want copy of children
-				Keys::iterator iter;
-				for (iter = children.begin(); iter != children.end(); ++iter)
-				{
-					if ((*iter) == childKey)
-					{
-						children.erase(iter);
-						break;
-					}
-				}
-			}
-		}
+		Keys& children = parent->second.children();  // note Keys& - we don't want copy of children
+		removeKey(children, childKey, false);
+		if (!edgesStale_)
+			edgesDirty_.insert(ids_.intern(parentKey));
 		return true;
 	}
 }
@@ -0,0 +1,388 @@
+#pragma once
+#ifndef _DBINDEX_H_
+#define _DBINDEX_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// DbIndex.h - secondary indexes over DbElement metadata                           //
+// ver 1.4                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package provides a single class, DbIndex, that maps DbElement
+* metadata back to the keys of the records holding it:
+* - a hash index on exact name
+* - a hash index on exact payload category
+* - an ordered index on DateTime ticks, for range queries
+* - a trigram index on description, for substring queries
+*
+* DbCore owns a DbIndex and keeps it current as records are inserted,
+* edited, and deleted.  Query uses it when a predicate can be answered
+* from an index instead of a scan.
+*
+* Payload categories are obtained through the indexCategories(payload)
+* customization point.  The default returns no categories; payload types
+* that have categories provide an overload in their own namespace.
+*
+*   ----------------------------------------------------------
+*   - index										: adds a record's metadata to the indexes
+*   - refresh									: reindexes a record only if its metadata changed
+*   - unindex									: removes everything indexed for a key
+*   - clear										: empties all indexes
+*   - byName									: keys whose name equals a string
+*   - byCategory								: keys whose payload has a category
+*   - byTime									: candidate keys whose dateTime may lie in an open interval
+*   - byTimeFrom								: next keys in time order after a saved position
+*   - byDescrip									: candidate keys whose description may contain a literal
+*   - canSearchDescrip							: is a literal long enough for the trigram index?
+*   - countName, countCategory					: number of keys byName, byCategory would return
+*   - countTime									: number of keys byTime would return, up to a limit
+*   - countDescrip								: upper bound on the keys byDescrip would return
+*
+* Required Files:
+* ---------------
+* DbIndex.h, DbCore.h
+* DateTime.h, DateTime.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.4 : 18 Oct 2026
+* - byTime and countTime include records in the same second as either
+*   end of the interval, since ticks are whole seconds
+* ver 1.3 : 18 Oct 2026
+* - refresh, so records that may have been edited can be checked cheaply
+* ver 1.2 : 18 Oct 2026
+* - cardinality counts, so a query planner can order its predicates
+* ver 1.1 : 18 Oct 2026
+* - time index ordered on (ticks, key) so scans can resume from a position
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <utility>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace NoSqlDb
+{
+	template<typename T> class DbElement;
+
+	//----< default category extraction for payloads without categories >-
+
+	template<typename P>
+	std::vector<std::string> indexCategories(const P&)
+	{
+		return std::vector<std::string>();
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// DbIndex class
+	// - secondary indexes on name, category, dateTime, and description
+	// - remembers what it indexed for each key, so a record can be
+	//   unindexed after it has been edited in place
+
+	template<typename T>
+	class DbIndex
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+		using Ticks = size_t;
+		using TimePos = std::pair<Ticks, Key>;  // position in the time index
+
+		void index(const Key& key, const DbElement<T>& elem);
+		void refresh(const Key& key, const DbElement<T>& elem);
+		void unindex(const Key& key);
+		void clear();
+		size_t size() const { return entries_.size(); }
+
+		Keys byName(const std::string& name) const;
+		Keys byCategory(const std::string& category) const;
+		Keys byTime(Ticks after, Ticks before) const;
+		Keys byTimeFrom(TimePos& pos, size_t count) const;
+		Keys byDescrip(const std::string& literal) const;
+		static bool canSearchDescrip(const std::string& literal) { return literal.size() >= gramSize; }
+
+		size_t countName(const std::string& name) const { return count(names_, name); }
+		size_t countCategory(const std::string& category) const { return count(categories_, category); }
+		size_t countTime(Ticks after, Ticks before, size_t limit) const;
+		size_t countDescrip(const std::string& literal) const;
+
+	private:
+		using Postings = std::unordered_map<std::string, std::unordered_set<Key>>;
+		static const size_t gramSize = 3;
+
+		struct Entry
+		{
+			std::string name;
+			std::string descrip;
+			std::vector<std::string> categories;
+			Ticks ticks;
+		};
+
+		static std::vector<std::string> grams(const std::string& text);
+		static void post(Postings& postings, const std::string& term, const Key& key);
+		static void unpost(Postings& postings, const std::string& term, const Key& key);
+		static Keys lookup(const Postings& postings, const std::string& term);
+		static size_t count(const Postings& postings, const std::string& term);
+
+		std::unordered_map<Key, Entry> entries_;
+		Postings names_;
+		Postings categories_;
+		Postings grams_;
+		std::set<TimePos> times_;
+	};
+
+	//----< distinct trigrams of text >----------------------------------
+
+	template<typename T>
+	std::vector<std::string> DbIndex<T>::grams(const std::string& text)
+	{
+		std::vector<std::string> result;
+		if (text.size() < gramSize)
+			return result;
+		result.reserve(text.size() - gramSize + 1);
+		for (size_t i = 0; i + gramSize <= text.size(); ++i)
+			result.push_back(text.substr(i, gramSize));
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+		return result;
+	}
+
+	//----< add key to the posting set for term >------------------------
+
+	template<typename T>
+	void DbIndex<T>::post(Postings& postings, const std::string& term, const Key& key)
+	{
+		postings[term].insert(key);
+	}
+
+	//----< remove key from the posting set for term >-------------------
+
+	template<typename T>
+	void DbIndex<T>::unpost(Postings& postings, const std::string& term, const Key& key)
+	{
+		auto iter = postings.find(term);
+		if (iter == postings.end())
+			return;
+		iter->second.erase(key);
+		if (iter->second.empty())
+			postings.erase(iter);
+	}
+
+	//----< keys posted for term >---------------------------------------
+
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::lookup(const Postings& postings, const std::string& term)
+	{
+		auto iter = postings.find(term);
+		if (iter == postings.end())
+			return Keys();
+		return Keys(iter->second.begin(), iter->second.end());
+	}
+
+	//----< number of keys posted for term >-----------------------------
+
+	template<typename T>
+	size_t DbIndex<T>::count(const Postings& postings, const std::string& term)
+	{
+		auto iter = postings.find(term);
+		return iter == postings.end() ? 0 : iter->second.size();
+	}
+
+	//----< add a record's metadata to the indexes >---------------------
+
+	template<typename T>
+	void DbIndex<T>::index(const Key& key, const DbElement<T>& elem)
+	{
+		unindex(key);
+		Entry entry;
+		entry.name = elem.name();
+		entry.descrip = elem.descrip();
+		entry.categories = indexCategories(elem.payLoad());
+		entry.ticks = elem.dateTime().ticks();
+
+		post(names_, entry.name, key);
+		for (const std::string& category : entry.categories)
+			post(categories_, category, key);
+		for (const std::string& gram : grams(entry.descrip))
+			post(grams_, gram, key);
+		times_.insert(TimePos(entry.ticks, key));
+		entries_[key] = std::move(entry);
+	}
+
+	//----< reindex key only if elem no longer matches its entry >-------
+	/*
+	*  - comparing costs a few string compares; reindexing would unpost
+	*    and repost every trigram of the description
+	*/
+
+	template<typename T>
+	void DbIndex<T>::refresh(const Key& key, const DbElement<T>& elem)
+	{
+		auto iter = entries_.find(key);
+		if (iter != entries_.end())
+		{
+			const Entry& entry = iter->second;
+			if (entry.name == elem.name() && entry.descrip == elem.descrip() &&
+				entry.ticks == elem.dateTime().ticks() && entry.categories == indexCategories(elem.payLoad()))
+				return;
+		}
+		index(key, elem);
+	}
+
+	//----< remove everything indexed for key >--------------------------
+
+	template<typename T>
+	void DbIndex<T>::unindex(const Key& key)
+	{
+		auto iter = entries_.find(key);
+		if (iter == entries_.end())
+			return;
+		const Entry& entry = iter->second;
+		unpost(names_, entry.name, key);
+		for (const std::string& category : entry.categories)
+			unpost(categories_, category, key);
+		for (const std::string& gram : grams(entry.descrip))
+			unpost(grams_, gram, key);
+		times_.erase(TimePos(entry.ticks, key));
+		entries_.erase(iter);
+	}
+
+	//----< empty all indexes >------------------------------------------
+
+	template<typename T>
+	void DbIndex<T>::clear()
+	{
+		entries_.clear();
+		names_.clear();
+		categories_.clear();
+		grams_.clear();
+		times_.clear();
+	}
+
+	//----< keys whose name equals name >--------------------------------
+
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::byName(const std::string& name) const
+	{
+		return lookup(names_, name);
+	}
+
+	//----< keys whose payload has category >----------------------------
+
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::byCategory(const std::string& category) const
+	{
+		return lookup(categories_, category);
+	}
+
+	//----< keys with after <= dateTime.ticks() <= before >--------------
+	/*
+	*  - ticks are whole seconds, so a record in the same second as either
+	*    end may lie inside the interval; callers compare dateTimes to
+	*    drop the ones that do not
+	*/
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::byTime(Ticks after, Ticks before) const
+	{
+		Keys keys;
+		auto iter = times_.lower_bound(TimePos(after, Key()));
+		for (; iter != times_.end() && iter->first <= before; ++iter)
+			keys.push_back(iter->second);
+		return keys;
+	}
+
+	//----< number of keys with after <= ticks <= before, at most limit >
+	/*
+	*  - costs O(log N + limit), so an estimate never walks a wide range
+	*/
+	template<typename T>
+	size_t DbIndex<T>::countTime(Ticks after, Ticks before, size_t limit) const
+	{
+		size_t count = 0;
+		auto iter = times_.lower_bound(TimePos(after, Key()));
+		for (; iter != times_.end() && iter->first <= before && count < limit; ++iter)
+			++count;
+		return count;
+	}
+
+	//----< up to count keys in time order after pos, advancing pos >----
+	/*
+	*  - costs O(log N + count); pos survives inserts and deletes, so a
+	*    caller can keep reading records that arrive later
+	*/
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::byTimeFrom(TimePos& pos, size_t count) const
+	{
+		Keys keys;
+		for (auto iter = times_.upper_bound(pos); iter != times_.end() && keys.size() < count; ++iter)
+		{
+			keys.push_back(iter->second);
+			pos = *iter;
+		}
+		return keys;
+	}
+
+	//----< candidate keys whose description may contain literal >-------
+	/*
+	*  - intersects the posting sets of every trigram of literal, starting
+	*    with the smallest, so callers must still verify each candidate
+	*  - requires canSearchDescrip(literal)
+	*/
+	template<typename T>
+	typename DbIndex<T>::Keys DbIndex<T>::byDescrip(const std::string& literal) const
+	{
+		std::vector<const std::unordered_set<Key>*> sets;
+		for (const std::string& gram : grams(literal))
+		{
+			auto iter = grams_.find(gram);
+			if (iter == grams_.end())
+				return Keys();
+			sets.push_back(&iter->second);
+		}
+		if (sets.empty())
+			return Keys();
+		std::sort(sets.begin(), sets.end(),
+			[](const std::unordered_set<Key>* a, const std::unordered_set<Key>* b) { return a->size() < b->size(); });
+		Keys keys;
+		for (const Key& key : *sets[0])
+		{
+			bool inAll = true;
+			for (size_t i = 1; i < sets.size() && inAll; ++i)
+				inAll = sets[i]->count(key) > 0;
+			if (inAll)
+				keys.push_back(key);
+		}
+		return keys;
+	}
+
+	//----< upper bound on keys byDescrip(literal) returns >-------------
+	/*
+	*  - size of the smallest trigram posting, without intersecting them
+	*  - requires canSearchDescrip(literal)
+	*/
+	template<typename T>
+	size_t DbIndex<T>::countDescrip(const std::string& literal) const
+	{
+		size_t smallest = entries_.size();
+		for (const std::string& gram : grams(literal))
+			smallest = std::min(smallest, count(grams_, gram));
+		return smallest;
+	}
+}
+
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+#ifndef _KEYTABLE_H_
+#define _KEYTABLE_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// KeyTable.h - interns db keys as dense integer record ids                        //
+// ver 1.1                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines a single class, KeyTable, that gives each distinct
+* key a small RecordId, so a graph of record relationships can be held
+* as vectors of 32-bit ids, and walked without hashing strings.  The
+* table holds its own copy of each key, beside the db's.
+*
+* The owner releases an id once nothing refers to its key any more, and
+* the next key interned is given a released id before a new one, so the
+* ids in use stay dense however many keys come and go.  An id released
+* may later name a different key.
+*
+*   ----------------------------------------------------------
+*   - intern									: id of key, adding key if it is new
+*   - find										: id of key, npos if key is not interned
+*   - key										: key for an id
+*   - release									: frees an id, and its key's memory, for reuse
+*   - size										: one more than the largest id handed out
+*   - count										: number of keys interned now
+*
+* Required Files:
+* ---------------
+* KeyTable.h
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.1 : 18 Oct 2026
+* - release, and reuse of released ids
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <exception>
+
+namespace NoSqlDb
+{
+	using RecordId = uint32_t;
+
+	/////////////////////////////////////////////////////////////////////
+	// KeyTable class
+	// - keys live in a deque, which never moves them, and the lookup map
+	//   holds pointers to them, so each key is stored only once
+	// - copies rebuild the map to point into their own deque
+	// - a released id's slot holds an empty key until the id is reused
+
+	class KeyTable
+	{
+	public:
+		using Key = std::string;
+		static const RecordId npos = UINT32_MAX;
+
+		KeyTable() {}
+		KeyTable(const KeyTable& table);
+		KeyTable(KeyTable&& table) = default;
+		KeyTable& operator=(const KeyTable& table);
+		KeyTable& operator=(KeyTable&& table) = default;
+
+		RecordId intern(const Key& key);
+		RecordId find(const Key& key) const;
+		const Key& key(RecordId id) const { return keys_[id]; }
+		void release(RecordId id);
+		size_t size() const { return keys_.size(); }
+		size_t count() const { return ids_.size(); }
+	private:
+		struct Hash
+		{
+			size_t operator()(const Key* key) const { return std::hash<Key>()(*key); }
+		};
+		struct Equal
+		{
+			bool operator()(const Key* a, const Key* b) const { return *a == *b; }
+		};
+
+		std::deque<Key> keys_;
+		std::unordered_map<const Key*, RecordId, Hash, Equal> ids_;
+		std::vector<RecordId> free_;  // released ids, reused first
+	};
+
+	//----< copy keys, with a map into the copy's own deque >------------
+
+	inline KeyTable::KeyTable(const KeyTable& table) : keys_(table.keys_), free_(table.free_)
+	{
+		std::vector<bool> released(keys_.size(), false);
+		for (RecordId id : free_)
+			released[id] = true;
+		ids_.reserve(keys_.size() - free_.size());
+		for (size_t i = 0; i < keys_.size(); ++i)
+		{
+			if (!released[i])
+				ids_[&keys_[i]] = static_cast<RecordId>(i);
+		}
+	}
+
+	inline KeyTable& KeyTable::operator=(const KeyTable& table)
+	{
+		if (this != &table)
+		{
+			KeyTable copy(table);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	//----< id of key, adding key with a released or new id if it is new >
+
+	inline RecordId KeyTable::intern(const Key& key)
+	{
+		auto iter = ids_.find(&key);
+		if (iter != ids_.end())
+			return iter->second;
+		RecordId id;
+		if (!free_.empty())
+		{
+			id = free_.back();
+			free_.pop_back();
+			keys_[id] = key;
+		}
+		else
+		{
+			if (keys_.size() >= npos)
+				throw(std::exception("too many keys for 32-bit record ids"));
+			id = static_cast<RecordId>(keys_.size());
+			keys_.push_back(key);
+		}
+		ids_[&keys_[id]] = id;
+		return id;
+	}
+
+	//----< free id for reuse; ids not in use are ignored >--------------
+
+	inline void KeyTable::release(RecordId id)
+	{
+		if (id >= keys_.size())
+			return;
+		auto iter = ids_.find(&keys_[id]);
+		if (iter == ids_.end() || iter->second != id)
+			return;
+		ids_.erase(iter);
+		Key().swap(keys_[id]);
+		free_.push_back(id);
+	}
+
+	//----< id of key, npos if it is not interned >----------------------
+
+	inline RecordId KeyTable::find(const Key& key) const
+	{
+		auto iter = ids_.find(&key);
+		return iter == ids_.end() ? npos : iter->second;
+	}
+}
+
+#endif
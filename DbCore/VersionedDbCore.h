@@ -0,0 +1,596 @@
+#pragma once
+#ifndef _VERSIONEDDBCORE_H_
+#define _VERSIONEDDBCORE_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// VersionedDbCore.h - multi-version NoSql database with O(1) snapshots            //
+// ver 1.1                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines two classes:
+* - VersionedDbCore keeps, for every key, a chain of immutable versions
+*   of its record, newest first, each stamped with the epoch of the
+*   commit that wrote it.  Every put, update, or erase is one commit and
+*   advances the epoch by one.
+* - DbSnapshot is a read-only view of a VersionedDbCore as of one epoch.
+*   Opening one records the epoch and takes no copy, so it is O(1) in
+*   the size of the db.  It sees, for each key, the newest version no
+*   later than its epoch, so writers keep committing while a long query
+*   runs against an image that does not change under it.
+*
+* DbSnapshot has the const interface Query uses - keys, contains,
+* operator[], begin/end, indexing, index - so Query<T, DbSnapshot<T>>
+* runs any query against a snapshot.
+*
+* Commits are serialized by a writer lock.  Readers take no lock to walk
+* records; only finding a key's slot takes a shared lock, which writers
+* hold exclusively just long enough to add a new key.  Slots live in
+* chunks that never move, so a snapshot can scan them while new keys
+* are being added.
+*
+* Old versions are reclaimed by epoch: reclaim finds the oldest epoch
+* any open snapshot still reads, and for each key drops every version
+* older than the newest one at or before that epoch.  No snapshot can
+* reach those versions, so they are freed without stopping readers.
+* reclaimEvery runs reclaim after every n commits.
+*
+*   ----------------------------------------------------------
+*   VersionedDbCore
+*   - put										: commits a new version of key's record
+*   - update									: commits a copy of key's record edited by f
+*   - erase										: commits the removal of key
+*   - contains, get								: latest committed state of key
+*   - epoch										: epoch of the latest commit
+*   - snapshot									: opens a DbSnapshot at the latest epoch
+*   - reclaim									: frees versions no snapshot can read
+*   - reclaimEvery								: runs reclaim after every n commits
+*   - versions									: number of versions retained
+*
+*   DbSnapshot
+*   - epoch										: epoch this snapshot reads
+*   - contains, operator[]						: record for key as of epoch
+*   - keys, size								: records as of epoch
+*   - begin, end								: iterate (key, record) pairs as of epoch
+*   - indexing, index							: snapshots have no secondary indexes
+*
+* Required Files:
+* ---------------
+* VersionedDbCore.h, DbCore.h, DbCore.cpp, DbIndex.h
+* DateTime.h, DateTime.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.1 : 18 Oct 2026
+* - DbSnapshot::iterator is default constructible, for Cursor
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <unordered_map>
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <cstdint>
+#include "DbCore.h"
+
+namespace NoSqlDb
+{
+	template<typename T>
+	class DbSnapshot;
+
+	/////////////////////////////////////////////////////////////////////
+	// VersionedDbCore class
+	// - versions are shared_ptr linked, newest first; heads are read and
+	//   written with std::atomic_load and std::atomic_store
+	// - slot i is in chunk c, where firstChunk << c is the size of chunk c
+
+	template<typename T>
+	class VersionedDbCore
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+		using Epoch = uint64_t;
+
+		VersionedDbCore();
+		VersionedDbCore(const VersionedDbCore&) = delete;
+		VersionedDbCore& operator=(const VersionedDbCore&) = delete;
+		~VersionedDbCore();
+
+		Epoch put(const Key& key, const DbElement<T>& elem);
+		template<typename F> bool update(const Key& key, F f);
+		bool erase(const Key& key);
+		bool contains(const Key& key) const;
+		DbElement<T> get(const Key& key) const;
+		Epoch epoch() const { return epoch_.load(); }
+
+		DbSnapshot<T> snapshot() const;
+		size_t reclaim();
+		void reclaimEvery(size_t commits) { reclaimEvery_ = commits; }
+		size_t versions() const;
+	private:
+		friend class DbSnapshot<T>;
+
+		struct Version
+		{
+			Epoch epoch;
+			std::unique_ptr<const DbElement<T>> elem;  // null when key was erased
+			std::shared_ptr<Version> older;
+		};
+		using VersionPtr = std::shared_ptr<Version>;
+
+		struct Slot
+		{
+			Key key;
+			VersionPtr head;
+		};
+
+		static const size_t firstChunk = 1024;
+		static const size_t maxChunks = 48;
+		static const size_t npos = static_cast<size_t>(-1);
+
+		Slot& slot(size_t index) const;
+		size_t find(const Key& key) const;
+		size_t findOrAdd(const Key& key);
+		Epoch commit(size_t index, std::unique_ptr<const DbElement<T>> elem);
+		const DbElement<T>* visible(size_t index, Epoch epoch) const;
+		size_t reclaimLocked();
+		static size_t freeChain(VersionPtr chain);
+		void release(Epoch epoch) const;
+
+		std::atomic<Slot*> chunks_[maxChunks];
+		std::atomic<size_t> slots_;
+		std::unordered_map<Key, size_t> slotOf_;
+		mutable std::shared_timed_mutex slotMutex_;
+		std::mutex writeMutex_;
+		std::atomic<Epoch> epoch_;
+		mutable std::mutex activeMutex_;
+		mutable std::map<Epoch, size_t> active_;  // open snapshots per epoch
+		size_t commits_ = 0;
+		size_t reclaimEvery_ = 0;
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	// DbSnapshot class
+	// - movable, not copyable; the db must outlive it
+	// - references returned by operator[] stay valid while it is open
+
+	template<typename T>
+	class DbSnapshot
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+		using Epoch = uint64_t;
+		using Item = std::pair<const Key&, const DbElement<T>&>;
+
+		class iterator
+		{
+		public:
+			iterator() : snapshot_(nullptr), index_(0) {}
+			iterator(const DbSnapshot* snapshot, size_t index) : snapshot_(snapshot), index_(index) { skip(); }
+			Item operator*() const { return Item(snapshot_->db_->slot(index_).key, *elem_); }
+			iterator& operator++() { ++index_; skip(); return *this; }
+			bool operator==(const iterator& other) const { return index_ == other.index_; }
+			bool operator!=(const iterator& other) const { return index_ != other.index_; }
+		private:
+			void skip();
+			const DbSnapshot* snapshot_;
+			size_t index_;
+			const DbElement<T>* elem_ = nullptr;
+		};
+
+		DbSnapshot(DbSnapshot&& other);
+		DbSnapshot& operator=(DbSnapshot&& other);
+		DbSnapshot(const DbSnapshot&) = delete;
+		DbSnapshot& operator=(const DbSnapshot&) = delete;
+		~DbSnapshot();
+
+		Epoch epoch() const { return epoch_; }
+		bool contains(const Key& key) const;
+		const DbElement<T>& operator[](const Key& key) const;
+		Keys keys() const;
+		size_t size() const;
+		iterator begin() const { return iterator(this, 0); }
+		iterator end() const { return iterator(this, slots_); }
+		bool indexing() const { return false; }
+		const DbIndex<T>& index() const;
+	private:
+		friend class VersionedDbCore<T>;
+		DbSnapshot(const VersionedDbCore<T>* db, Epoch epoch, size_t slots) : db_(db), epoch_(epoch), slots_(slots) {}
+
+		const VersionedDbCore<T>* db_;
+		Epoch epoch_;
+		size_t slots_;  // keys added after the snapshot opened are not visited
+	};
+
+	//----< construct an empty db at epoch 0 >---------------------------
+
+	template<typename T>
+	VersionedDbCore<T>::VersionedDbCore() : slots_(0), epoch_(0)
+	{
+		for (auto& chunk : chunks_)
+			chunk.store(nullptr);
+	}
+
+	//----< free every version and slot >--------------------------------
+
+	template<typename T>
+	VersionedDbCore<T>::~VersionedDbCore()
+	{
+		size_t count = slots_.load();
+		for (size_t i = 0; i < count; ++i)
+			freeChain(std::move(slot(i).head));
+		for (auto& chunk : chunks_)
+			delete[] chunk.load();
+	}
+
+	//----< slot at index, which must be less than slots_ >--------------
+
+	template<typename T>
+	typename VersionedDbCore<T>::Slot& VersionedDbCore<T>::slot(size_t index) const
+	{
+		size_t biased = index + firstChunk;
+		size_t bit = 0;
+		while ((biased >> (bit + 1)) != 0)
+			++bit;
+		size_t chunk = bit - 10;  // firstChunk == 1 << 10
+		return chunks_[chunk].load()[biased - (size_t(1) << bit)];
+	}
+
+	//----< index of key's slot, npos if key was never written >---------
+
+	template<typename T>
+	size_t VersionedDbCore<T>::find(const Key& key) const
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(slotMutex_);
+		auto iter = slotOf_.find(key);
+		return iter == slotOf_.end() ? npos : iter->second;
+	}
+
+	//----< index of key's slot, adding one if needed; writers only >----
+	/*
+	*  - the slot is filled in before slots_ counts it, so readers never
+	*    see a slot without its key
+	*/
+	template<typename T>
+	size_t VersionedDbCore<T>::findOrAdd(const Key& key)
+	{
+		size_t index = find(key);
+		if (index != npos)
+			return index;
+		index = slots_.load();
+		size_t chunk = 0;
+		while (index + firstChunk >= (firstChunk << (chunk + 1)))
+			++chunk;
+		if (chunk >= maxChunks)
+			throw(std::exception("versioned db is full"));
+		if (chunks_[chunk].load() == nullptr)
+			chunks_[chunk].store(new Slot[firstChunk << chunk]);
+		slot(index).key = key;
+		{
+			std::unique_lock<std::shared_timed_mutex> lock(slotMutex_);
+			slotOf_[key] = index;
+		}
+		slots_.store(index + 1);
+		return index;
+	}
+
+	//----< link a new version at the head of a slot's chain >-----------
+	/*
+	*  - the head is published before the epoch advances, so a snapshot
+	*    at the new epoch always finds it
+	*/
+	template<typename T>
+	typename VersionedDbCore<T>::Epoch VersionedDbCore<T>::commit(size_t index, std::unique_ptr<const DbElement<T>> elem)
+	{
+		Slot& s = slot(index);
+		VersionPtr version = std::make_shared<Version>();
+		version->epoch = epoch_.load() + 1;
+		version->elem = std::move(elem);
+		version->older = std::atomic_load(&s.head);
+		std::atomic_store(&s.head, version);
+		epoch_.store(version->epoch);
+		if (reclaimEvery_ > 0 && ++commits_ % reclaimEvery_ == 0)
+			reclaimLocked();
+		return version->epoch;
+	}
+
+	//----< commit a new version of key's record >-----------------------
+
+	template<typename T>
+	typename VersionedDbCore<T>::Epoch VersionedDbCore<T>::put(const Key& key, const DbElement<T>& elem)
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		return commit(findOrAdd(key), std::unique_ptr<const DbElement<T>>(new DbElement<T>(elem)));
+	}
+
+	//----< commit a copy of key's record edited by f(DbElement<T>&) >---
+	/*
+	*  - returns false, committing nothing, if key is not in the db
+	*/
+	template<typename T>
+	template<typename F>
+	bool VersionedDbCore<T>::update(const Key& key, F f)
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		size_t index = find(key);
+		const DbElement<T>* current = index == npos ? nullptr : visible(index, epoch_.load());
+		if (current == nullptr)
+			return false;
+		std::unique_ptr<DbElement<T>> elem(new DbElement<T>(*current));
+		f(*elem);
+		commit(index, std::move(elem));
+		return true;
+	}
+
+	//----< commit the removal of key, false if key is not in the db >---
+
+	template<typename T>
+	bool VersionedDbCore<T>::erase(const Key& key)
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		size_t index = find(key);
+		if (index == npos || visible(index, epoch_.load()) == nullptr)
+			return false;
+		commit(index, nullptr);
+		return true;
+	}
+
+	//----< newest version of slot's record no later than epoch >--------
+	/*
+	*  - null if there is none, or the key was erased as of epoch
+	*/
+	template<typename T>
+	const DbElement<T>* VersionedDbCore<T>::visible(size_t index, Epoch epoch) const
+	{
+		VersionPtr head = std::atomic_load(&slot(index).head);
+		const Version* version = head.get();
+		while (version != nullptr && version->epoch > epoch)
+			version = version->older.get();
+		return version == nullptr ? nullptr : version->elem.get();
+	}
+
+	//----< is key in the latest committed state? >---------------------
+
+	template<typename T>
+	bool VersionedDbCore<T>::contains(const Key& key) const
+	{
+		size_t index = find(key);
+		if (index == npos)
+			return false;
+		VersionPtr head = std::atomic_load(&slot(index).head);
+		return head != nullptr && head->elem != nullptr;
+	}
+
+	//----< copy of key's latest record, throws if key is not in db >----
+
+	template<typename T>
+	DbElement<T> VersionedDbCore<T>::get(const Key& key) const
+	{
+		size_t index = find(key);
+		VersionPtr head = index == npos ? nullptr : std::atomic_load(&slot(index).head);
+		if (head == nullptr || head->elem == nullptr)
+			throw(std::exception("key does not exist in db"));
+		return *head->elem;
+	}
+
+	//----< open a snapshot at the latest epoch >------------------------
+	/*
+	*  - registered under activeMutex_ so reclaim never frees a version
+	*    the snapshot can read
+	*/
+	template<typename T>
+	DbSnapshot<T> VersionedDbCore<T>::snapshot() const
+	{
+		std::lock_guard<std::mutex> lock(activeMutex_);
+		Epoch epoch = epoch_.load();
+		++active_[epoch];
+		return DbSnapshot<T>(this, epoch, slots_.load());
+	}
+
+	//----< forget a closed snapshot >-----------------------------------
+
+	template<typename T>
+	void VersionedDbCore<T>::release(Epoch epoch) const
+	{
+		std::lock_guard<std::mutex> lock(activeMutex_);
+		auto iter = active_.find(epoch);
+		if (iter != active_.end() && --iter->second == 0)
+			active_.erase(iter);
+	}
+
+	//----< free versions no open snapshot can read >--------------------
+
+	template<typename T>
+	size_t VersionedDbCore<T>::reclaim()
+	{
+		std::lock_guard<std::mutex> lock(writeMutex_);
+		return reclaimLocked();
+	}
+
+	//----< reclaim, with writeMutex_ held >-----------------------------
+	/*
+	*  - every open snapshot reads at or after oldest, so each stops at or
+	*    before the newest version no later than oldest, and never follows
+	*    that version's older link
+	*  - an erased key whose erasure every snapshot sees loses its head too
+	*/
+	template<typename T>
+	size_t VersionedDbCore<T>::reclaimLocked()
+	{
+		Epoch oldest;
+		{
+			std::lock_guard<std::mutex> lock(activeMutex_);
+			oldest = active_.empty() ? epoch_.load() : active_.begin()->first;
+		}
+		size_t freed = 0;
+		size_t count = slots_.load();
+		for (size_t i = 0; i < count; ++i)
+		{
+			Slot& s = slot(i);
+			VersionPtr head = std::atomic_load(&s.head);
+			Version* version = head.get();
+			while (version != nullptr && version->epoch > oldest)
+				version = version->older.get();
+			if (version == nullptr)
+				continue;
+			freed += freeChain(std::move(version->older));
+			if (version == head.get() && version->elem == nullptr)
+			{
+				std::atomic_store(&s.head, VersionPtr());
+				head.reset();
+				++freed;
+			}
+		}
+		return freed;
+	}
+
+	//----< unlink a chain one version at a time, returning its length >-
+	/*
+	*  - iterative, so a long chain does not recurse through destructors
+	*/
+	template<typename T>
+	size_t VersionedDbCore<T>::freeChain(VersionPtr chain)
+	{
+		size_t count = 0;
+		while (chain != nullptr)
+		{
+			VersionPtr older = std::move(chain->older);
+			chain = std::move(older);
+			++count;
+		}
+		return count;
+	}
+
+	//----< number of versions retained, including erasures >------------
+
+	template<typename T>
+	size_t VersionedDbCore<T>::versions() const
+	{
+		size_t count = 0;
+		size_t slots = slots_.load();
+		for (size_t i = 0; i < slots; ++i)
+		{
+			VersionPtr head = std::atomic_load(&slot(i).head);
+			for (const Version* version = head.get(); version != nullptr; version = version->older.get())
+				++count;
+		}
+		return count;
+	}
+
+	//----< move a snapshot, leaving other closed >----------------------
+
+	template<typename T>
+	DbSnapshot<T>::DbSnapshot(DbSnapshot&& other) : db_(other.db_), epoch_(other.epoch_), slots_(other.slots_)
+	{
+		other.db_ = nullptr;
+	}
+
+	template<typename T>
+	DbSnapshot<T>& DbSnapshot<T>::operator=(DbSnapshot&& other)
+	{
+		if (this != &other)
+		{
+			if (db_ != nullptr)
+				db_->release(epoch_);
+			db_ = other.db_;
+			epoch_ = other.epoch_;
+			slots_ = other.slots_;
+			other.db_ = nullptr;
+		}
+		return *this;
+	}
+
+	//----< close snapshot, letting reclaim free what only it could read >
+
+	template<typename T>
+	DbSnapshot<T>::~DbSnapshot()
+	{
+		if (db_ != nullptr)
+			db_->release(epoch_);
+	}
+
+	//----< was key in the db as of epoch? >-----------------------------
+
+	template<typename T>
+	bool DbSnapshot<T>::contains(const Key& key) const
+	{
+		size_t index = db_->find(key);
+		return index < slots_ && db_->visible(index, epoch_) != nullptr;
+	}
+
+	//----< key's record as of epoch, throws if key was not in db >------
+
+	template<typename T>
+	const DbElement<T>& DbSnapshot<T>::operator[](const Key& key) const
+	{
+		size_t index = db_->find(key);
+		const DbElement<T>* elem = index < slots_ ? db_->visible(index, epoch_) : nullptr;
+		if (elem == nullptr)
+			throw(std::exception("key does not exist in db"));
+		return *elem;
+	}
+
+	//----< keys of all records as of epoch >----------------------------
+
+	template<typename T>
+	typename DbSnapshot<T>::Keys DbSnapshot<T>::keys() const
+	{
+		Keys keys;
+		for (const auto& item : *this)
+			keys.push_back(item.first);
+		return keys;
+	}
+
+	//----< number of records as of epoch; visits every slot >-----------
+
+	template<typename T>
+	size_t DbSnapshot<T>::size() const
+	{
+		size_t count = 0;
+		for (iterator iter = begin(); iter != end(); ++iter)
+			++count;
+		return count;
+	}
+
+	//----< snapshots have no secondary indexes, as DbCore with indexing off >
+
+	template<typename T>
+	const DbIndex<T>& DbSnapshot<T>::index() const
+	{
+		static const DbIndex<T> none;
+		return none;
+	}
+
+	//----< advance past slots with no record as of epoch >--------------
+
+	template<typename T>
+	void DbSnapshot<T>::iterator::skip()
+	{
+		for (; index_ < snapshot_->slots_; ++index_)
+		{
+			elem_ = snapshot_->db_->visible(index_, snapshot_->epoch_);
+			if (elem_ != nullptr)
+				return;
+		}
+	}
+}
+
+#endif
@@ -682,14 +682,14 @@ bool testQueryonPayLoad()
 	std::string category = "thirdCategory";
 	std::cout << "\n  select on payload categories for \"" << category << "\"\n";
 
-	auto hasCategory = [&category](DbElement<PayLoad>& elem) {
+	auto hasCategory = [&category](const DbElement<PayLoad>& elem) {
 		return (elem.payLoad()).hasCategory(category);
 	};
 
 	q9.select(hasCategory).show();
 
 	std::string value = "Test Payload #1";
-	auto hasValue = [&value](DbElement<PayLoad>& elem) {
+	auto hasValue = [&value](const DbElement<PayLoad>& elem) {
 		return (elem.payLoad()).filePath() == value;
 	};
 	Utilities::putline();
@@ -27,7 +27,7 @@ namespace NoSqlDb
 	template<typename P>
 	struct IPayLoad
 	{
-		virtual Sptr toXmlElement() = 0;
+		virtual Sptr toXmlElement() const = 0;
 		static P fromXmlElement(Sptr elem);
 		virtual ~IPayLoad() {};
 	};
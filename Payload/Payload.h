@@ -2,7 +2,7 @@
 #define PAYLOAD_H
 ///////////////////////////////////////////////////////////////////////
 // PayLoad.h - application defined payload                           //
-// ver 1.1                                                           //
+// ver 1.4                                                           //
 // Jim Fawcett, CSE687 - Object Oriented Design, Spring 2018         //
 ///////////////////////////////////////////////////////////////////////
 /*
@@ -12,8 +12,11 @@
 *  - holds a payload string and vector of categories
 *  - provides means to set and access those values
 *  - provides methods used by Persist<PayLoad>:
-*    - Sptr toXmlElement();
+*    - Sptr toXmlElement() const;
 *    - static PayLoad fromXmlElement(Sptr elem);
+*  - provides methods used by Snapshot<PayLoad>:
+*    - void toBinary(BinaryWriter& out) const;
+*    - static PayLoad fromBinary(BinaryReader& in);
 *  - provides a show function to display PayLoad specific information
 *  - PayLoad processing is very simple, so this package contains only
 *    a header file, making it easy to use in other packages, e.g.,
@@ -23,9 +26,17 @@
 *  ---------------
 *    PayLoad.h, PayLoad.cpp - application defined package
 *    DbCore.h, DbCore.cpp
+*    BinaryStream.h
 *
 *  Maintenance History:
 *  --------------------
+*  ver 1.4 : 18 Oct 2026
+*  - const getters return references, setters move; toXmlElement is
+*    const; showDb reads records without copying them
+*  ver 1.3 : 18 Oct 2026
+*  - added toBinary and fromBinary, used by Snapshot<PayLoad>
+*  ver 1.2 : 18 Oct 2026
+*  - fromXmlElement accepts empty filepath and categories elements
 *  ver 1.1 : 19 Feb 2018
 *  - added inheritance from IPayLoad interface
 *  Ver 1.0 : 10 Feb 2018
@@ -39,6 +50,7 @@
 #include "../XmlDocument/XmlDocument.h"
 #include "../XmlDocument/XmlElement.h"
 #include "../DbCore/DbCore.h"
+#include "../Persist/BinaryStream.h"
 #include "IPayLoad.h"
 
 ///////////////////////////////////////////////////////////////////////
@@ -47,8 +59,11 @@
 // - a vector of string categories, which for Project #2, will be 
 //   Repository categories
 // - methods used by Persist<PayLoad>:
-//   - Sptr toXmlElement();
+//   - Sptr toXmlElement() const;
 //   - static PayLoad fromXmlElement(Sptr elem);
+// - methods used by Snapshot<PayLoad>:
+//   - void toBinary(BinaryWriter& out) const;
+//   - static PayLoad fromBinary(BinaryReader& in);
 
 
 namespace NoSqlDb
@@ -60,21 +75,21 @@ namespace NoSqlDb
 		using Categories = std::vector<std::string>;
 
 		PayLoad() = default;
-		PayLoad(const FilePath& filePath) : filePath_(filePath) {}
+		PayLoad(FilePath filePath) : filePath_(std::move(filePath)) {}
 		static void identify(std::ostream& out = std::cout);
 		PayLoad& operator=(const FilePath& filePath)
 		{
 			filePath_ = filePath;
 			return *this;
 		}
-		operator std::string() { return filePath_; }
+		operator std::string() const { return filePath_; }
 
-		FilePath filePath() const { return filePath_; }
+		const FilePath& filePath() const { return filePath_; }
 		FilePath& filePath() { return filePath_; }
-		void filePath(const FilePath& filePath) { filePath_ = filePath; }
+		void filePath(FilePath filePath) { filePath_ = std::move(filePath); }
 
 		Categories& categories() { return categories_; }
-		Categories categories() const { return categories_; }
+		const Categories& categories() const { return categories_; }
 
 		bool isOpen() const { return isOpen_; }
 		bool& isOpen() { return isOpen_; }
@@ -85,17 +100,19 @@ namespace NoSqlDb
 		void isClosed(const bool& status) { isClosed_ = status; }
 
 
-		bool hasCategory(const std::string& cat)
+		bool hasCategory(const std::string& cat) const
 		{
-			return std::find(categories().begin(), categories().end(), cat) != categories().end();
+			return std::find(categories_.begin(), categories_.end(), cat) != categories_.end();
 		}
 
-		Sptr toXmlElement();
+		Sptr toXmlElement() const;
 		static PayLoad fromXmlElement(Sptr elem);
+		void toBinary(BinaryWriter& out) const;
+		static PayLoad fromBinary(BinaryReader& in);
 
 		static void showPayLoadHeaders(std::ostream& out = std::cout);
-		static void showElementPayLoad(NoSqlDb::DbElement<PayLoad>& elem, std::ostream& out = std::cout);
-		static void showDb(NoSqlDb::DbCore<PayLoad>& db, std::ostream& out = std::cout);
+		static void showElementPayLoad(const NoSqlDb::DbElement<PayLoad>& elem, std::ostream& out = std::cout);
+		static void showDb(const NoSqlDb::DbCore<PayLoad>& db, std::ostream& out = std::cout);
 	private:
 		FilePath filePath_;
 		Categories categories_;
@@ -103,6 +120,12 @@ namespace NoSqlDb
 		bool isClosed_ = false;
 	};
 
+	//----< categories used by DbCore's category index >-----------------
+
+	inline std::vector<std::string> indexCategories(const PayLoad& payLoad)
+	{
+		return payLoad.categories();
+	}
 	//----< show file name >---------------------------------------------
 
 	inline void PayLoad::identify(std::ostream& out)
@@ -113,7 +136,7 @@ namespace NoSqlDb
 	/*
 	* - Required by Persist<PayLoad>
 	*/
-	inline Sptr PayLoad::toXmlElement()
+	inline Sptr PayLoad::toXmlElement() const
 	{
 		Sptr sPtr = XmlProcessing::makeTaggedElement("payload");
 		XmlProcessing::XmlDocument doc(makeDocElement(sPtr));
@@ -121,7 +144,7 @@ namespace NoSqlDb
 		sPtr->addChild(sPtrVal);
 		Sptr sPtrCats = XmlProcessing::makeTaggedElement("categories");
 		sPtr->addChild(sPtrCats);
-		for (auto cat : categories_)
+		for (const auto& cat : categories_)
 		{
 			Sptr sPtrCat = XmlProcessing::makeTaggedElement("category", cat);
 			sPtrCats->addChild(sPtrCat);
@@ -138,6 +161,8 @@ namespace NoSqlDb
 		for (auto pChild : pElem->children())
 		{
 			std::string tag = pChild->tag();
+			if (pChild->children().size() == 0)
+				continue;  // empty element
 			std::string val = pChild->children()[0]->value();
 			if (tag == "filepath")
 			{
@@ -154,6 +179,30 @@ namespace NoSqlDb
 		}
 		return pl;
 	}
+	//----< write PayLoad instance to a binary snapshot >----------------
+	/*
+	* - Required by Snapshot<PayLoad>
+	*/
+	inline void PayLoad::toBinary(BinaryWriter& out) const
+	{
+		out.string(filePath_);
+		out.number(categories_.size());
+		for (const std::string& cat : categories_)
+			out.ref(cat);
+	}
+	//----< create PayLoad instance from a binary snapshot >-------------
+	/*
+	* - Required by Snapshot<PayLoad>
+	*/
+	inline PayLoad PayLoad::fromBinary(BinaryReader& in)
+	{
+		PayLoad pl;
+		pl.filePath(in.string());
+		size_t count = static_cast<size_t>(in.number());
+		for (size_t i = 0; i < count; ++i)
+			pl.categories().push_back(in.ref());
+		return pl;
+	}
 	/////////////////////////////////////////////////////////////////////
 	// PayLoad display functions
 
@@ -174,12 +223,12 @@ namespace NoSqlDb
 	}
 
 
-	inline void PayLoad::showElementPayLoad(NoSqlDb::DbElement<PayLoad>& elem, std::ostream& out)
+	inline void PayLoad::showElementPayLoad(const NoSqlDb::DbElement<PayLoad>& elem, std::ostream& out)
 	{
 		out << "\n  ";
 		out << std::setw(25) << std::left << elem.name().substr(0, 23);
 		out << std::setw(30) << std::left << elem.payLoad().filePath().substr(0, 38);
-		for (auto cat : elem.payLoad().categories())
+		for (const auto& cat : elem.payLoad().categories())
 		{
 			out << std::setw(20) << std::left << cat.substr(0, 18) << " ";
 		}
@@ -187,14 +236,11 @@ namespace NoSqlDb
 		out << std::setw(15) << std::left << elem.payLoad().isClosed();
 	}
 
-	inline void PayLoad::showDb(NoSqlDb::DbCore<PayLoad>& db, std::ostream& out)
+	inline void PayLoad::showDb(const NoSqlDb::DbCore<PayLoad>& db, std::ostream& out)
 	{
 		showPayLoadHeaders(out);
-		for (auto item : db)
-		{
-			NoSqlDb::DbElement<PayLoad> temp = item.second;
-			PayLoad::showElementPayLoad(temp, out);
-		}
+		for (const auto& item : db)
+			PayLoad::showElementPayLoad(item.second, out);
 	}
 }
 #endif
@@ -0,0 +1,372 @@
+#pragma once
+#ifndef _BINARYSTREAM_H_
+#define _BINARYSTREAM_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// BinaryStream.h - read and write checksummed blocks of binary records            //
+// ver 1.2                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package provides the encoding used by Snapshot files:
+* - BinaryWriter collects records into blocks and writes each block to a
+*   std::ostream with its length, record count, and CRC-32
+* - BinaryReader reads those blocks back, verifying each CRC before any
+*   of the block's records are decoded
+*
+* The CRC covers a block's length and record count as well as its bytes.
+* A record is at least one byte, so a block never claims more records
+* than bytes, and the reader grows a block only as its bytes arrive, so
+* a damaged header cannot make it allocate more than the stream holds.
+*
+* Inside a block, numbers are written as variable length unsigned
+* integers, seven bits per byte, and strings as a length followed by
+* their bytes.  Strings that repeat, like child keys and categories,
+* are written with ref: the first time a string is seen it is written
+* in full and given the next id in a string table, after that only its
+* id is written.  The table is built as the stream is written and read,
+* so it never has to be stored separately.
+*
+*   ----------------------------------------------------------
+*   BinaryWriter
+*   - number									: writes an unsigned integer
+*   - string									: writes a length-prefixed string
+*   - ref										: writes a string through the string table
+*   - endRecord									: ends a record, writing the block when it is full
+*   - flush										: writes the records collected so far as a block
+*   - close										: writes the last block and the end marker
+*   - fixed32									: writes a four byte little-endian integer, outside any block
+*
+*   BinaryReader
+*   - nextBlock									: reads and verifies the next block
+*   - records									: number of records in the current block
+*   - atBlockEnd								: has all of the current block been read?
+*   - number, string, ref						: read what the writer's methods wrote
+*   - fixed32									: reads a four byte little-endian integer, outside any block
+*
+*   - crc32										: CRC-32 (IEEE 802.3) of a byte range, optionally continuing another
+*
+* Required Files:
+* ---------------
+* BinaryStream.h
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.2 : 18 Oct 2026
+* - the block CRC covers the length and record count, and the reader
+*   checks both before allocating for them
+* ver 1.1 : 18 Oct 2026
+* - added flush, so a log can write one block per commit
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <exception>
+
+namespace NoSqlDb
+{
+	//----< CRC-32 (IEEE 802.3, reflected) of size bytes at data >-------
+	/*
+	*  - crc32(b, m, crc32(a, n)) is the CRC of a's n bytes followed by b's m
+	*/
+	inline uint32_t crc32(const char* data, size_t size, uint32_t crc = 0)
+	{
+		static const std::vector<uint32_t> table = []()
+		{
+			std::vector<uint32_t> t(256);
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t c = i;
+				for (int bit = 0; bit < 8; ++bit)
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				t[i] = c;
+			}
+			return t;
+		}();
+		crc ^= 0xFFFFFFFFu;
+		for (size_t i = 0; i < size; ++i)
+			crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// BinaryWriter class
+	// - block layout: length, record count, bytes, CRC-32 of all three,
+	//   with the integers written by fixed32
+	// - every record must hold at least one byte
+	// - an empty block marks the end of the stream
+
+	class BinaryWriter
+	{
+	public:
+		BinaryWriter(std::ostream& out, size_t blockSize = 1 << 16) : out_(out), blockSize_(blockSize) {}
+		void number(uint64_t value);
+		void string(const std::string& str);
+		void ref(const std::string& str);
+		void endRecord();
+		void flush();
+		void close();
+		static void fixed32(std::ostream& out, uint32_t value);
+		static void fixed32(char* bytes, uint32_t value);
+	private:
+		void writeBlock();
+
+		std::ostream& out_;
+		size_t blockSize_;
+		std::string block_;
+		size_t recordStart_ = 0;
+		uint32_t records_ = 0;
+		std::unordered_map<std::string, uint64_t> ids_;
+	};
+
+	//----< write value seven bits at a time, low bits first >-----------
+
+	inline void BinaryWriter::number(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			block_ += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		block_ += static_cast<char>(value);
+	}
+
+	//----< write length, then bytes, of str >---------------------------
+
+	inline void BinaryWriter::string(const std::string& str)
+	{
+		number(str.size());
+		block_ += str;
+	}
+
+	//----< write str through the string table >-------------------------
+	/*
+	*  - 0 followed by the string defines the next id, n > 0 refers to
+	*    id n - 1
+	*/
+	inline void BinaryWriter::ref(const std::string& str)
+	{
+		auto iter = ids_.find(str);
+		if (iter != ids_.end())
+		{
+			number(iter->second + 1);
+			return;
+		}
+		number(0);
+		string(str);
+		uint64_t id = ids_.size();
+		ids_[str] = id;
+	}
+
+	//----< end a record, writing the block once it is full >------------
+
+	inline void BinaryWriter::endRecord()
+	{
+		if (block_.size() == recordStart_)
+			throw(std::exception("binary record is empty"));
+		++records_;
+		recordStart_ = block_.size();
+		if (block_.size() >= blockSize_)
+			writeBlock();
+	}
+
+	//----< write the records collected so far, if any, as a block >----
+
+	inline void BinaryWriter::flush()
+	{
+		if (records_ > 0)
+			writeBlock();
+	}
+
+	//----< write the last block and the end marker >--------------------
+
+	inline void BinaryWriter::close()
+	{
+		flush();
+		writeBlock();
+	}
+
+	//----< write the records collected so far as one block >------------
+
+	inline void BinaryWriter::writeBlock()
+	{
+		if (block_.size() > UINT32_MAX)
+			throw(std::exception("binary record too large for a block"));
+		char header[8];
+		fixed32(header, static_cast<uint32_t>(block_.size()));
+		fixed32(header + 4, records_);
+		out_.write(header, sizeof(header));
+		out_.write(block_.data(), block_.size());
+		fixed32(out_, crc32(block_.data(), block_.size(), crc32(header, sizeof(header))));
+		block_.clear();
+		recordStart_ = 0;
+		records_ = 0;
+	}
+
+	//----< write value as four little-endian bytes >--------------------
+
+	inline void BinaryWriter::fixed32(std::ostream& out, uint32_t value)
+	{
+		char bytes[4];
+		fixed32(bytes, value);
+		out.write(bytes, 4);
+	}
+
+	//----< store value as four little-endian bytes at bytes >-----------
+
+	inline void BinaryWriter::fixed32(char* bytes, uint32_t value)
+	{
+		for (size_t i = 0; i < 4; ++i)
+			bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// BinaryReader class
+	// - throws if a block is truncated, fails its CRC, or is read past
+	//   its end
+
+	class BinaryReader
+	{
+	public:
+		BinaryReader(std::istream& in) : in_(in) {}
+		bool nextBlock();
+		size_t records() const { return records_; }
+		bool atBlockEnd() const { return pos_ == block_.size(); }
+		uint64_t number();
+		std::string string();
+		std::string ref();
+		static uint32_t fixed32(std::istream& in);
+		static uint32_t fixed32(const char* bytes);
+
+		static const size_t readChunk = 1 << 16;  // most bytes a block grows by per read
+	private:
+		void need(size_t count) const;
+
+		std::istream& in_;
+		std::string block_;
+		size_t pos_ = 0;
+		size_t records_ = 0;
+		std::vector<std::string> strings_;
+	};
+
+	//----< read and verify the next block, false at the end marker >----
+	/*
+	*  - the length is trusted only as far as the stream bears it out:
+	*    the block is read a chunk at a time, so a damaged length fails
+	*    as a truncated stream before the CRC is checked
+	*/
+	inline bool BinaryReader::nextBlock()
+	{
+		char header[8];
+		in_.read(header, sizeof(header));
+		if (!in_.good())
+			throw(std::exception("binary stream truncated"));
+		uint32_t size = fixed32(header);
+		records_ = fixed32(header + 4);
+		if (records_ > size)
+			throw(std::exception("binary block holds more records than bytes"));
+		block_.clear();
+		pos_ = 0;
+		while (block_.size() < size)
+		{
+			size_t have = block_.size();
+			size_t chunk = static_cast<size_t>(size) - have;
+			if (chunk > readChunk)
+				chunk = readChunk;
+			block_.resize(have + chunk);
+			in_.read(&block_[have], chunk);
+			if (!in_.good())
+				throw(std::exception("binary stream truncated"));
+		}
+		if (fixed32(in_) != crc32(block_.data(), block_.size(), crc32(header, sizeof(header))))
+			throw(std::exception("binary block failed its CRC check"));
+		return size > 0;
+	}
+
+	//----< throw unless count more bytes remain in the block >----------
+
+	inline void BinaryReader::need(size_t count) const
+	{
+		if (block_.size() - pos_ < count)
+			throw(std::exception("binary record runs past the end of its block"));
+	}
+
+	//----< read a number written by BinaryWriter::number >--------------
+
+	inline uint64_t BinaryReader::number()
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			need(1);
+			unsigned char byte = static_cast<unsigned char>(block_[pos_++]);
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		throw(std::exception("binary number too long"));
+	}
+
+	//----< read a string written by BinaryWriter::string >--------------
+
+	inline std::string BinaryReader::string()
+	{
+		uint64_t size = number();
+		need(static_cast<size_t>(size));
+		std::string str(block_, pos_, static_cast<size_t>(size));
+		pos_ += static_cast<size_t>(size);
+		return str;
+	}
+
+	//----< read a string written by BinaryWriter::ref >-----------------
+
+	inline std::string BinaryReader::ref()
+	{
+		uint64_t id = number();
+		if (id == 0)
+		{
+			strings_.push_back(string());
+			return strings_.back();
+		}
+		if (id > strings_.size())
+			throw(std::exception("binary string id out of range"));
+		return strings_[static_cast<size_t>(id - 1)];
+	}
+
+	//----< read four little-endian bytes >------------------------------
+
+	inline uint32_t BinaryReader::fixed32(std::istream& in)
+	{
+		char bytes[4] = { 0, 0, 0, 0 };
+		in.read(bytes, 4);
+		if (!in.good())
+			throw(std::exception("binary stream truncated"));
+		return fixed32(bytes);
+	}
+
+	//----< four little-endian bytes at bytes >--------------------------
+
+	inline uint32_t BinaryReader::fixed32(const char* bytes)
+	{
+		const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+		return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+	}
+}
+
+#endif
@@ -0,0 +1,598 @@
+#pragma once
+#ifndef _MAPPEDDB_H_
+#define _MAPPEDDB_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// MappedDb.h - read-only db served from a memory-mapped file                      //
+// ver 1.3                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines classes that open a db file by mapping it into
+* memory, read-only, and answer DbCore-style lookups straight from the
+* mapped pages:
+* - MappedDb<T> builds the file from a DbCore<T> and serves contains,
+*   operator[], keys, size, and iteration over records
+* - MappedRecord<T> is a view of one record.  Its key, name, description,
+*   and children are MappedStrings pointing into the file, so reading
+*   them allocates nothing.  payLoad() decodes the payload on request.
+* - MappedFile maps a whole file, using CreateFileMapping on Windows and
+*   mmap elsewhere
+*
+* Opening costs one mapping, whatever the size of the db, and processes
+* that open the same file share its pages through the OS page cache.
+*
+* File layout, all integers little-endian:
+*   header  : "NSDM", version (u32), record count (u64), bucket count (u64),
+*             offset of the bucket table (u64)
+*   records : key, name, description (each a u32 length and bytes),
+*             dateTime ticks (u64), child count (u32), child keys,
+*             payload (u32 length and the bytes T::toBinary writes)
+*   buckets : open addressed hash table of record offsets (u64), 0 for
+*             empty, probed linearly from FNV-1a(key)
+*
+* Every offset and length read from a file is checked against the
+* mapping before it is followed, so a damaged file throws, or fails to
+* open, instead of reading outside the file.  The records themselves
+* carry no checksums; use Snapshot to move a db between hosts with them.
+*
+*   ----------------------------------------------------------
+*   MappedDb
+*   - build										: writes a mapped db file from a DbCore
+*   - open, close, isOpen						: maps and unmaps a file
+*   - contains									: does the db hold key?
+*   - find										: record for key, or an invalid record
+*   - operator[]								: record for key, throws if there is none
+*   - keys, size								: keys of, and number of, records
+*   - begin, end								: iterate over records in file order
+*
+* Required Files:
+* ---------------
+* MappedDb.h, BinaryStream.h
+* DbCore.h, DbCore.cpp
+* DateTime.h, DateTime.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.3 : 18 Oct 2026
+* - offsets and lengths read from the file are checked against it, and
+*   find probes each bucket at most once
+* ver 1.2 : 18 Oct 2026
+* - format version 2, for BinaryStream's new block CRC in payloads
+* ver 1.1 : 18 Oct 2026
+* - children read without copying them
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
+#include <cstddef>
+#include "../DbCore/DbCore.h"
+#include "../DateTime/DateTime.h"
+#include "BinaryStream.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// MappedFile class
+	// - maps a whole file read-only, unmaps it on close or destruction
+
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { close(); }
+		bool open(const std::string& fileSpec);
+		void close();
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+	};
+
+	//----< map fileSpec, false if it can't be opened or is empty >------
+
+	inline bool MappedFile::open(const std::string& fileSpec)
+	{
+		close();
+#ifdef _WIN32
+		file_ = CreateFileA(fileSpec.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view == nullptr)
+		{
+			close();
+			return false;
+		}
+		data_ = static_cast<const char*>(view);
+		size_ = static_cast<size_t>(size.QuadPart);
+#else
+		int fd = ::open(fileSpec.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			::close(fd);
+			return false;
+		}
+		void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);  // the mapping keeps the file open
+		if (view == MAP_FAILED)
+			return false;
+		data_ = static_cast<const char*>(view);
+		size_ = static_cast<size_t>(info.st_size);
+#endif
+		return true;
+	}
+
+	//----< unmap the file, if one is mapped >---------------------------
+
+	inline void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (data_ != nullptr)
+			UnmapViewOfFile(data_);
+		if (mapping_ != nullptr)
+			CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_);
+		mapping_ = nullptr;
+		file_ = INVALID_HANDLE_VALUE;
+#else
+		if (data_ != nullptr)
+			munmap(const_cast<char*>(data_), size_);
+#endif
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// MappedString class
+	// - characters in a mapped file, valid while the file is mapped
+
+	class MappedString
+	{
+	public:
+		MappedString() = default;
+		MappedString(const char* data, size_t size) : data_(data), size_(size) {}
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+		std::string str() const { return std::string(data_, size_); }
+		operator std::string() const { return str(); }
+		bool operator==(const std::string& other) const
+		{
+			return size_ == other.size() && std::memcmp(data_, other.data(), size_) == 0;
+		}
+		bool operator!=(const std::string& other) const { return !(*this == other); }
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+	};
+
+	//----< read little-endian integers from mapped bytes >--------------
+
+	inline uint32_t mappedU32(const char* p)
+	{
+		const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+		return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+	}
+
+	inline uint64_t mappedU64(const char* p)
+	{
+		return mappedU32(p) | (static_cast<uint64_t>(mappedU32(p + 4)) << 32);
+	}
+
+	//----< throw unless count bytes remain between p and end >---------
+
+	inline void mappedNeed(const char* p, const char* end, size_t count)
+	{
+		if (static_cast<size_t>(end - p) < count)
+			throw(std::exception("mapped record runs past the end of its file"));
+	}
+
+	//----< length-prefixed string at p, advancing p past it >-----------
+	/*
+	*  - end is the first byte the string may not reach
+	*/
+	inline MappedString mappedString(const char*& p, const char* end)
+	{
+		mappedNeed(p, end, 4);
+		size_t size = mappedU32(p);
+		mappedNeed(p + 4, end, size);
+		MappedString str(p + 4, size);
+		p += 4 + size;
+		return str;
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// MappedChildren class
+	// - range of a record's child keys, read in place
+
+	class MappedChildren
+	{
+	public:
+		class iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = MappedString;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const MappedString*;
+			using reference = MappedString;
+
+			iterator(const char* p, size_t remaining, const char* end) : p_(p), remaining_(remaining), end_(end) {}
+			MappedString operator*() const { const char* p = p_; return mappedString(p, end_); }
+			iterator& operator++() { mappedString(p_, end_); --remaining_; return *this; }
+			bool operator==(const iterator& other) const { return remaining_ == other.remaining_; }
+			bool operator!=(const iterator& other) const { return remaining_ != other.remaining_; }
+		private:
+			const char* p_;
+			size_t remaining_;
+			const char* end_;
+		};
+
+		MappedChildren(const char* first, size_t count, const char* end) : first_(first), count_(count), end_(end) {}
+		iterator begin() const { return iterator(first_, count_, end_); }
+		iterator end() const { return iterator(first_, 0, end_); }
+		size_t size() const { return count_; }
+	private:
+		const char* first_;
+		size_t count_;
+		const char* end_;
+	};
+
+	/////////////////////////////////////////////////////////////////////
+	// MappedRecord class
+	// - view of one record in a mapped db file
+	// - a default constructed record is invalid, find returns one for
+	//   keys that are not in the db
+
+	template<typename T>
+	class MappedRecord
+	{
+	public:
+		MappedRecord() = default;
+		MappedRecord(const char* p, const char* end);
+		bool valid() const { return start_ != nullptr; }
+		MappedString key() const { return key_; }
+		MappedString name() const { return name_; }
+		MappedString descrip() const { return descrip_; }
+		size_t ticks() const { return static_cast<size_t>(mappedU64(after_)); }
+		DateTime dateTime() const;
+		MappedChildren children() const { return MappedChildren(after_ + 12, mappedU32(after_ + 8), end_); }
+		T payLoad() const;
+		const char* next() const;
+	private:
+		MappedString payLoadBytes() const;
+
+		const char* start_ = nullptr;
+		const char* after_ = nullptr;  // ticks, then children
+		const char* end_ = nullptr;    // end of the file's records
+		MappedString key_;
+		MappedString name_;
+		MappedString descrip_;
+	};
+
+	//----< view of the record starting at p, ending before end >-------
+
+	template<typename T>
+	MappedRecord<T>::MappedRecord(const char* p, const char* end) : start_(p), end_(end)
+	{
+		key_ = mappedString(p, end);
+		name_ = mappedString(p, end);
+		descrip_ = mappedString(p, end);
+		mappedNeed(p, end, 12);
+		after_ = p;
+	}
+
+	//----< dateTime, rebuilt from its ticks >---------------------------
+
+	template<typename T>
+	DateTime MappedRecord<T>::dateTime() const
+	{
+		std::chrono::seconds secs(static_cast<std::chrono::seconds::rep>(ticks()));
+		return DateTime(DateTime::TimePoint(secs));
+	}
+
+	//----< bytes T::toBinary wrote for this record's payload >----------
+
+	template<typename T>
+	MappedString MappedRecord<T>::payLoadBytes() const
+	{
+		const char* p = after_ + 12;
+		for (size_t i = mappedU32(after_ + 8); i > 0; --i)
+			mappedString(p, end_);
+		return mappedString(p, end_);
+	}
+
+	//----< decode payload, the one accessor that allocates >------------
+
+	template<typename T>
+	T MappedRecord<T>::payLoad() const
+	{
+		MappedString bytes = payLoadBytes();
+		std::istringstream in(bytes.str());
+		BinaryReader reader(in);
+		reader.nextBlock();
+		return T::fromBinary(reader);
+	}
+
+	//----< start of the record that follows this one >------------------
+
+	template<typename T>
+	const char* MappedRecord<T>::next() const
+	{
+		MappedString bytes = payLoadBytes();
+		return bytes.data() + bytes.size();
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// MappedDb class
+	// - read-only db over a file written by build
+
+	template<typename T>
+	class MappedDb
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+		using Record = MappedRecord<T>;
+		static const uint32_t version = 2;
+
+		class iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Record;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const Record*;
+			using reference = Record;
+
+			iterator(const char* p, const char* end) : p_(p), end_(end) {}
+			Record operator*() const { return Record(p_, end_); }
+			iterator& operator++() { p_ = Record(p_, end_).next(); return *this; }
+			bool operator==(const iterator& other) const { return p_ == other.p_; }
+			bool operator!=(const iterator& other) const { return p_ != other.p_; }
+		private:
+			const char* p_;
+			const char* end_;
+		};
+
+		MappedDb() = default;
+		explicit MappedDb(const std::string& fileSpec) { open(fileSpec); }
+		static bool build(const DbCore<T>& db, const std::string& fileSpec);
+		bool open(const std::string& fileSpec);
+		void close() { file_.close(); }
+		bool isOpen() const { return file_.data() != nullptr; }
+
+		size_t size() const { return isOpen() ? static_cast<size_t>(mappedU64(file_.data() + 8)) : 0; }
+		bool contains(const Key& key) const { return find(key).valid(); }
+		Record find(const Key& key) const;
+		Record operator[](const Key& key) const;
+		Keys keys() const;
+		iterator begin() const { return iterator(isOpen() ? file_.data() + headerSize : nullptr, recordsEnd()); }
+		iterator end() const { return iterator(recordsEnd(), recordsEnd()); }
+	private:
+		static const size_t headerSize = 32;
+		static uint64_t hash(const char* data, size_t size);
+		static void put32(std::ostream& out, uint32_t value) { BinaryWriter::fixed32(out, value); }
+		static void put64(std::ostream& out, uint64_t value);
+		static void putString(std::ostream& out, const std::string& str);
+		size_t bucketCount() const { return static_cast<size_t>(mappedU64(file_.data() + 16)); }
+		size_t bucketsOffset() const { return static_cast<size_t>(mappedU64(file_.data() + 24)); }
+		const char* recordsEnd() const { return isOpen() ? file_.data() + bucketsOffset() : nullptr; }
+
+		MappedFile file_;
+	};
+
+	//----< FNV-1a, stable across processes and platforms >--------------
+
+	template<typename T>
+	uint64_t MappedDb<T>::hash(const char* data, size_t size)
+	{
+		uint64_t h = 14695981039346656037ull;
+		for (size_t i = 0; i < size; ++i)
+		{
+			h ^= static_cast<unsigned char>(data[i]);
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	//----< write eight little-endian bytes >----------------------------
+
+	template<typename T>
+	void MappedDb<T>::put64(std::ostream& out, uint64_t value)
+	{
+		put32(out, static_cast<uint32_t>(value));
+		put32(out, static_cast<uint32_t>(value >> 32));
+	}
+
+	//----< write a u32 length and the bytes of str >--------------------
+
+	template<typename T>
+	void MappedDb<T>::putString(std::ostream& out, const std::string& str)
+	{
+		put32(out, static_cast<uint32_t>(str.size()));
+		out.write(str.data(), str.size());
+	}
+
+	//----< write a mapped db file holding db's records >----------------
+
+	template<typename T>
+	bool MappedDb<T>::build(const DbCore<T>& db, const std::string& fileSpec)
+	{
+		std::ofstream out(fileSpec, std::ios::binary);
+		if (!out.good())
+			return false;
+
+		size_t buckets = 1;
+		while (buckets < 2 * db.size())
+			buckets *= 2;
+		std::vector<uint64_t> table(buckets, 0);
+
+		out.write("NSDM", 4);
+		put32(out, version);
+		put64(out, db.size());
+		put64(out, buckets);
+		put64(out, 0);  // bucket table offset, written last
+
+		for (const auto& item : db)
+		{
+			uint64_t offset = static_cast<uint64_t>(out.tellp());
+			size_t slot = static_cast<size_t>(hash(item.first.data(), item.first.size())) & (buckets - 1);
+			while (table[slot] != 0)
+				slot = (slot + 1) & (buckets - 1);
+			table[slot] = offset;
+
+			const DbElement<T>& elem = item.second;
+			putString(out, item.first);
+			putString(out, elem.name());
+			putString(out, elem.descrip());
+			put64(out, elem.dateTime().ticks());
+			const typename DbElement<T>::Children& children = elem.children();
+			put32(out, static_cast<uint32_t>(children.size()));
+			for (const Key& child : children)
+				putString(out, child);
+			std::ostringstream payLoad;
+			BinaryWriter writer(payLoad);
+			elem.payLoad().toBinary(writer);
+			writer.endRecord();
+			writer.close();
+			putString(out, payLoad.str());
+		}
+
+		uint64_t tableOffset = static_cast<uint64_t>(out.tellp());
+		for (uint64_t offset : table)
+			put64(out, offset);
+		out.seekp(24);
+		put64(out, tableOffset);
+		out.close();
+		return !out.fail();
+	}
+
+	//----< map fileSpec, false if it is not a mapped db file >----------
+	/*
+	*  - checks the header's bucket table and record count against the
+	*    file; records are checked as they are read
+	*/
+	template<typename T>
+	bool MappedDb<T>::open(const std::string& fileSpec)
+	{
+		if (!file_.open(fileSpec))
+			return false;
+		const char* p = file_.data();
+		bool ok = file_.size() >= headerSize && std::memcmp(p, "NSDM", 4) == 0
+			&& mappedU32(p + 4) == version
+			&& bucketsOffset() >= headerSize && bucketsOffset() <= file_.size()
+			&& bucketCount() > 0 && (bucketCount() & (bucketCount() - 1)) == 0
+			&& (file_.size() - bucketsOffset()) / 8 >= bucketCount()
+			&& size() <= bucketCount();
+		if (!ok)
+			file_.close();
+		return ok;
+	}
+
+	//----< record for key, invalid if key is not in db >----------------
+	/*
+	*  - visits each bucket at most once, so a table with no empty
+	*    bucket cannot make it loop
+	*  - throws if a bucket points outside the file's records
+	*/
+	template<typename T>
+	typename MappedDb<T>::Record MappedDb<T>::find(const Key& key) const
+	{
+		if (!isOpen())
+			return Record();
+		const char* buckets = recordsEnd();
+		size_t mask = bucketCount() - 1;
+		size_t slot = static_cast<size_t>(hash(key.data(), key.size())) & mask;
+		for (size_t probes = 0; probes < bucketCount(); ++probes)
+		{
+			uint64_t offset = mappedU64(buckets + 8 * slot);
+			if (offset == 0)
+				return Record();
+			if (offset < headerSize || offset >= bucketsOffset())
+				throw(std::exception("mapped db bucket points outside its records"));
+			const char* p = file_.data() + offset;
+			if (mappedString(p, recordsEnd()) == key)
+				return Record(file_.data() + offset, recordsEnd());
+			slot = (slot + 1) & mask;
+		}
+		return Record();
+	}
+
+	//----< record for key, throws if key is not in db >-----------------
+
+	template<typename T>
+	typename MappedDb<T>::Record MappedDb<T>::operator[](const Key& key) const
+	{
+		Record record = find(key);
+		if (!record.valid())
+			throw(std::exception("key does not exist in db"));
+		return record;
+	}
+
+	//----< keys of all records, in file order >-------------------------
+
+	template<typename T>
+	typename MappedDb<T>::Keys MappedDb<T>::keys() const
+	{
+		Keys keys;
+		keys.reserve(size());
+		for (Record record : *this)
+			keys.push_back(record.key());
+		return keys;
+	}
+}
+
+#endif
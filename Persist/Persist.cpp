@@ -27,6 +27,12 @@
 *   - testR3b								: demonstrate second part of requirement #3 and first part of requirement #4
 *   - testXml								: demonstrate first part of requirement #8
 *   - testCreateNewDbFromXmlFile			: demonstrate second part of requirement #8
+*   - testStreamingRestore					: restore through XmlReader matches the saved db
+*   - testStreamingSave						: save through XmlWriter matches XmlDocument's XML
+*   - sameRecords							: do two dbs hold the same records?
+*   - testSnapshot							: binary snapshot round trip, CRC check, and XML conversion
+*   - testMappedDb							: lookups served from a memory-mapped db file
+*   - testWal								: snapshot plus log replay, compaction, and a torn log tail
 *
 * Required Files:
 * ---------------
@@ -38,6 +44,9 @@
 * XmlDocument.h, XmlDocument.cpp,
 * XmlElement.h, XmlElement.cpp,
 * XmlUtilities.h, XmlUtilities.cpp
+* Snapshot.h, BinaryStream.h
+* MappedDb.h
+* Wal.h
 *
 * Build Process:
 * --------------
@@ -50,9 +59,15 @@
 
 
 #include "Persist.h"
+#include "Snapshot.h"
+#include "MappedDb.h"
+#include "Wal.h"
 #include "../DbCore/DbCore.h"
 #include "../Utilities/StringUtilities/StringUtilities.h"
 #include "../Utilities/TestUtilities/TestUtilities.h"
+#include <fstream>
+#include <functional>
+#include <iterator>
 
 using namespace NoSqlDb;
 
@@ -219,6 +234,448 @@ bool testCreateNewDbFromXmlFile()
 	putLine();
 	return true;
 }
+//----< restore through XmlReader matches the saved db >----------------------
+
+bool testStreamingRestore()
+{
+	Utilities::title("Restoring a db from an XML stream, one record at a time");
+	DbCore<PayLoad> db;
+	DbElement<PayLoad> elem;
+	elem.name("Jim");
+	elem.descrip("Instructor for CSE687");
+	elem.dateTime(DateTime().now());
+	PayLoad pL;
+	pL.filePath("C:/Jim.txt");
+	pL.categories().push_back("Instructor");
+	pL.categories().push_back("Faculty");
+	elem.payLoad(pL);
+	db["Fawcett"] = elem;
+
+	elem.name("Ammar");
+	elem.descrip("");         // empty elements must survive the trip
+	elem.payLoad(PayLoad());
+	db["Salman"] = elem;
+	db["Fawcett"].children().push_back("Salman");
+
+	Persist<PayLoad> persist(db);
+	std::string xml = "<?xml version=\"1.0\"?><!-- saved db -->" + persist.save();
+
+	DbCore<PayLoad> newDb;
+	Persist<PayLoad> persist2(newDb);
+	std::istringstream in(xml);
+	persist2.restore(in);
+	putLine();
+
+	if (newDb.size() != db.size())
+		return false;
+	for (const auto& item : static_cast<const DbCore<PayLoad>&>(db))
+	{
+		if (!newDb.contains(item.first))
+			return false;
+		const DbElement<PayLoad>& restored = static_cast<const DbCore<PayLoad>&>(newDb)[item.first];
+		if (restored.name() != item.second.name() || restored.descrip() != item.second.descrip())
+			return false;
+		if (restored.children() != item.second.children())
+			return false;
+		if (restored.payLoad().filePath() != item.second.payLoad().filePath())
+			return false;
+		if (restored.payLoad().categories() != item.second.payLoad().categories())
+			return false;
+	}
+	std::cout << "\n  restored " << newDb.size() << " records, children of \"Fawcett\": "
+		<< newDb["Fawcett"].children().size();
+
+	// a stream that ends inside a record throws, and leaves no part of it in db
+	DbCore<PayLoad> cutDb;
+	Persist<PayLoad> persist3(cutDb);
+	std::istringstream cutIn(xml.substr(0, xml.rfind("<name>")));
+	try
+	{
+		persist3.restore(cutIn);
+		return false;
+	}
+	catch (std::exception& ex)
+	{
+		std::cout << "\n  truncated XML rejected: " << ex.what();
+	}
+	return cutDb.size() == db.size() - 1 && !cutDb.contains("");
+}
+
+//----< save through XmlWriter matches XmlDocument's XML >--------------------
+
+bool testStreamingSave()
+{
+	Utilities::title("Saving a db as an XML stream, one record at a time");
+	DbCore<PayLoad> db;
+	DbElement<PayLoad> elem;
+	elem.name("Jim");
+	elem.descrip("Instructor for CSE687");
+	PayLoad pL;
+	pL.filePath("C:/Jim.txt");
+	pL.categories().push_back("Instructor");
+	elem.payLoad(pL);
+	db["Fawcett"] = elem;
+	elem.name("Ammar");
+	elem.descrip("");
+	elem.payLoad(PayLoad());
+	db["Salman"] = elem;
+	db["Fawcett"].children().push_back("Salman");
+
+	// the tree Persist<T>::save built before it streamed
+	using Sptr = std::shared_ptr<AbstractXmlElement>;
+	Sptr pDb = makeTaggedElement("db");
+	pDb->addAttrib("type", "testDb");
+	XmlDocument xDoc(makeDocElement(pDb));
+	for (const auto& item : static_cast<const DbCore<PayLoad>&>(db))
+	{
+		Sptr pRecord = makeTaggedElement("dbRecord");
+		pDb->addChild(pRecord);
+		pRecord->addChild(makeTaggedElement("key", item.first));
+		Sptr pValue = makeTaggedElement("value");
+		pRecord->addChild(pValue);
+		pValue->addChild(makeTaggedElement("name", item.second.name()));
+		pValue->addChild(makeTaggedElement("description", item.second.descrip()));
+		pValue->addChild(makeTaggedElement("date", item.second.dateTime()));
+		Sptr pChildren = makeTaggedElement("children");
+		for (auto child : item.second.children())
+			pChildren->addChild(makeTaggedElement("childKey", child));
+		pValue->addChild(pChildren);
+		pValue->addChild(item.second.payLoad().toXmlElement());
+	}
+
+	Persist<PayLoad> persist(db);
+	std::string xml = persist.save();
+	std::cout << xml;
+	putLine();
+	return xml == xDoc.toString();
+}
+
+//----< do two dbs hold the same records? >-----------------------------------
+
+bool sameRecords(const DbCore<PayLoad>& db1, const DbCore<PayLoad>& db2)
+{
+	if (db1.size() != db2.size())
+		return false;
+	for (const auto& item : db1)
+	{
+		if (!db2.contains(item.first))
+			return false;
+		const DbElement<PayLoad>& other = db2[item.first];
+		if (other.name() != item.second.name() || other.descrip() != item.second.descrip())
+			return false;
+		if (other.dateTime().ticks() != item.second.dateTime().ticks())
+			return false;
+		if (other.children() != item.second.children())
+			return false;
+		if (other.payLoad().filePath() != item.second.payLoad().filePath())
+			return false;
+		if (other.payLoad().categories() != item.second.payLoad().categories())
+			return false;
+	}
+	return true;
+}
+
+//----< binary snapshot round trip, CRC check, and XML conversion >-----------
+
+bool testSnapshot()
+{
+	Utilities::title("Saving and restoring a binary snapshot");
+	DbCore<PayLoad> db;
+	for (size_t i = 0; i < 500; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.name("name" + std::to_string(i));
+		elem.descrip(i % 7 == 0 ? "" : "record number " + std::to_string(i));
+		PayLoad pL;
+		pL.filePath("C:/files/" + std::to_string(i) + ".txt");
+		pL.categories().push_back(i % 2 ? "odd" : "even");
+		elem.payLoad(pL);
+		db["key" + std::to_string(i)] = elem;
+		if (i > 0)
+			db["key" + std::to_string(i - 1)].children().push_back("key" + std::to_string(i));
+	}
+
+	std::ostringstream out;
+	Snapshot<PayLoad>(db).save(out);
+	std::string bytes = out.str();
+	std::cout << "\n  " << db.size() << " records: " << bytes.size() << " snapshot bytes, "
+		<< Persist<PayLoad>(db).save().size() << " XML bytes";
+
+	DbCore<PayLoad> newDb;
+	std::istringstream in(bytes);
+	Snapshot<PayLoad>(newDb).restore(in);
+	if (!sameRecords(db, newDb))
+		return false;
+
+	// a flipped bit is caught by the block CRC, and a damaged length or
+	// record count before anything is sized from it
+	auto rejected = [](const std::string& damaged)
+	{
+		try
+		{
+			DbCore<PayLoad> badDb;
+			std::istringstream badIn(damaged);
+			Snapshot<PayLoad>(badDb).restore(badIn);
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << "\n  damaged snapshot rejected: " << ex.what();
+			return true;
+		}
+		return false;
+	};
+	std::string damaged = bytes;
+	damaged[damaged.size() / 2] ^= 0x10;
+	std::string longBlock = bytes;
+	longBlock[11] = '\x7F';  // high byte of the first block's length
+	std::string manyRecords = bytes;
+	manyRecords[15] = '\x7F';  // high byte of its record count
+	std::string fewerRecords = bytes;
+	fewerRecords[12] ^= 0x01;
+	if (!rejected(damaged) || !rejected(longBlock) || !rejected(manyRecords) || !rejected(fewerRecords))
+		return false;
+
+	// a block whose records leave bytes unread is rejected before any of it is loaded
+	std::ostringstream trailingOut;
+	trailingOut.write("NSDB", 4);
+	BinaryWriter::fixed32(trailingOut, Snapshot<PayLoad>::version);
+	BinaryWriter trailingWriter(trailingOut);
+	Snapshot<PayLoad>::writeRecord(trailingWriter, "key0", DbElement<PayLoad>());
+	trailingWriter.number(7);
+	trailingWriter.endRecord();
+	trailingWriter.close();
+	DbCore<PayLoad> trailingDb;
+	std::istringstream trailingIn(trailingOut.str());
+	try
+	{
+		Snapshot<PayLoad>(trailingDb).restore(trailingIn);
+		return false;
+	}
+	catch (std::exception& ex)
+	{
+		std::cout << "\n  damaged snapshot rejected: " << ex.what();
+	}
+	if (trailingDb.size() != 0)
+		return false;
+
+	// XML -> snapshot -> XML keeps every record
+	if (!Persist<PayLoad>(db).saveToFile("SnapshotTest.xml"))
+		return false;
+	if (!Snapshot<PayLoad>::xmlToSnapshot("SnapshotTest.xml", "SnapshotTest.bin"))
+		return false;
+	if (!Snapshot<PayLoad>::snapshotToXml("SnapshotTest.bin", "SnapshotTest2.xml"))
+		return false;
+	DbCore<PayLoad> xmlDb1, xmlDb2;
+	Persist<PayLoad>(xmlDb1).restoreFromFile("SnapshotTest.xml");
+	Persist<PayLoad>(xmlDb2).restoreFromFile("SnapshotTest2.xml");
+	putLine();
+	return xmlDb1.size() == db.size() && sameRecords(xmlDb1, xmlDb2);
+}
+
+//----< lookups served from a memory-mapped db file >-------------------------
+
+bool testMappedDb()
+{
+	Utilities::title("Serving lookups from a memory-mapped db file");
+	DbCore<PayLoad> db;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.name("name" + std::to_string(i));
+		elem.descrip("record number " + std::to_string(i));
+		PayLoad pL;
+		pL.filePath("C:/files/" + std::to_string(i) + ".txt");
+		pL.categories().push_back(i % 2 ? "odd" : "even");
+		elem.payLoad(pL);
+		db["key" + std::to_string(i)] = elem;
+	}
+	for (size_t i = 1; i < 10; ++i)
+		db.addChild("key0", "key" + std::to_string(i));
+
+	if (!MappedDb<PayLoad>::build(db, "MappedTest.db"))
+		return false;
+	MappedDb<PayLoad> mdb("MappedTest.db");
+	if (!mdb.isOpen() || mdb.size() != db.size())
+		return false;
+
+	const DbCore<PayLoad>& cdb = db;
+	for (const auto& item : cdb)
+	{
+		MappedDb<PayLoad>::Record record = mdb.find(item.first);
+		if (!record.valid() || record.key() != item.first)
+			return false;
+		if (record.name() != item.second.name() || record.descrip() != item.second.descrip())
+			return false;
+		if (record.ticks() != item.second.dateTime().ticks())
+			return false;
+		if (record.payLoad().filePath() != item.second.payLoad().filePath())
+			return false;
+	}
+	if (mdb.contains("no such key") || mdb.keys().size() != db.size())
+		return false;
+
+	std::cout << "\n  children of key0:";
+	size_t count = 0;
+	for (MappedString child : mdb["key0"].children())
+	{
+		std::cout << " " << child.str();
+		if (!mdb.contains(child) || child != cdb["key0"].children()[count++])
+			return false;
+	}
+	bool caught = false;
+	try
+	{
+		mdb["no such key"];
+	}
+	catch (std::exception&)
+	{
+		caught = true;
+	}
+	if (!caught || count != 9)
+		return false;
+
+	// damaged files fail to open, or throw, instead of reading outside the file
+	std::ifstream in("MappedTest.db", std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	size_t tableAt = static_cast<size_t>(mappedU64(bytes.data() + 24));
+	auto setU64 = [](std::string& file, size_t at, uint64_t value)
+	{
+		for (size_t i = 0; i < 8; ++i)
+			file[at + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+	};
+	auto fillTable = [&](uint64_t offset)
+	{
+		std::string file = bytes;
+		for (size_t at = tableAt; at + 8 <= file.size(); at += 8)
+			setU64(file, at, offset);
+		return file;
+	};
+	MappedDb<PayLoad> damaged;
+	auto reopen = [&damaged](const std::string& file)
+	{
+		damaged.close();
+		std::ofstream out("MappedDamaged.db", std::ios::binary);
+		out.write(file.data(), file.size());
+		out.close();
+		return damaged.open("MappedDamaged.db");
+	};
+	auto throws = [](std::function<void()> read)
+	{
+		try
+		{
+			read();
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << "\n  damaged mapped db rejected: " << ex.what();
+			return true;
+		}
+		return false;
+	};
+
+	std::string badCount = bytes;
+	setU64(badCount, 16, 3);  // bucket count that is not a power of two
+	if (reopen(badCount))
+		return false;
+	if (!reopen(fillTable(32)) || damaged.contains("no such key"))  // no empty bucket to stop a probe
+		return false;
+	if (!reopen(fillTable(tableAt + 8)) || !throws([&] { damaged.find("key1"); }))
+		return false;
+	std::string longKey = bytes;
+	setU64(longKey, 32, 0x7FFFFFFF7FFFFFFFull);  // first record's key length
+	if (!reopen(longKey) || !throws([&] { damaged.keys(); }))
+		return false;
+	damaged.close();
+	putLine();
+	return true;
+}
+
+//----< snapshot plus log replay, compaction, and a torn log tail >-----------
+
+bool testWal()
+{
+	Utilities::title("Logging changes ahead of snapshots");
+	std::remove("WalTest.log");
+	std::remove("WalTest.snap");
+	DbCore<PayLoad> db;
+	{
+		Wal<PayLoad> wal(db, "WalTest.log", "WalTest.snap");
+		if (!wal.recover())
+			return false;
+		for (size_t i = 0; i < 20; ++i)
+		{
+			DbElement<PayLoad> elem;
+			elem.name("name" + std::to_string(i));
+			PayLoad pL("C:/files/" + std::to_string(i) + ".txt");
+			pL.categories().push_back("logged");
+			elem.payLoad(pL);
+			wal.put("key" + std::to_string(i), elem);
+		}
+		wal.addChild("key0", "key1");
+		wal.addChild("key0", "key2");
+		wal.addChild("key1", "key3");
+		wal.compact();
+		if (wal.logSize() != 0)
+			return false;
+
+		// changes after the snapshot, committed in groups of four
+		wal.groupSize(4);
+		wal.syncEvery(2);
+		wal.deleteChild("key0", "key1");
+		wal.deleteRecord("key3");
+		wal.addChild("key4", "key5");
+		DbElement<PayLoad> elem = static_cast<const DbCore<PayLoad>&>(db)["key6"];
+		elem.descrip("edited after the snapshot");
+		wal.put("key6", elem);
+		if (wal.pending() != 0)
+			return false;
+		wal.put("key7", elem);  // committed when wal goes out of scope
+	}
+
+	DbCore<PayLoad> recovered;
+	{
+		Wal<PayLoad> wal(recovered, "WalTest.log", "WalTest.snap");
+		if (!wal.recover())
+			return false;
+	}
+	std::cout << "\n  recovered " << recovered.size() << " records from snapshot and log";
+	if (!sameRecords(db, recovered))
+		return false;
+
+	// a crash in the middle of a write leaves a torn block
+	std::ofstream log("WalTest.log", std::ios::binary | std::ios::app);
+	log << "\x40\x00\x00\x00\x01\x00\x00\x00torn";
+	log.close();
+	DbCore<PayLoad> afterCrash;
+	{
+		Wal<PayLoad> wal(afterCrash, "WalTest.log", "WalTest.snap");
+		if (!wal.recover())
+			return false;
+		std::cout << "\n  torn block cut off, log is " << wal.logSize() << " bytes";
+	}
+	if (!sameRecords(db, afterCrash))
+		return false;
+
+	// a block with bytes its entries do not account for is rejected whole
+	{
+		std::ofstream bad("WalTest.log", std::ios::binary | std::ios::app);
+		BinaryWriter writer(bad, SIZE_MAX);
+		writer.number(Wal<PayLoad>::putOp);
+		Snapshot<PayLoad>::writeRecord(writer, "unaccounted", DbElement<PayLoad>());
+		writer.number(0);
+		writer.endRecord();
+		writer.flush();
+	}
+	DbCore<PayLoad> afterBadBlock;
+	Wal<PayLoad> wal(afterBadBlock, "WalTest.log", "WalTest.snap");
+	if (!wal.recover())
+		return false;
+	std::cout << "\n  block with trailing bytes rejected, log is " << wal.logSize() << " bytes";
+	putLine();
+	return sameRecords(db, afterBadBlock) && !afterBadBlock.contains("unaccounted");
+}
+
 #ifdef TEST_PERSIST
 using namespace Utilities;
 int main()
@@ -231,11 +688,21 @@ int main()
 	TestExecutive::TestStr ts2{ testR3b, "Creating DbCore and adding element with key" };
 	TestExecutive::TestStr ts3{ testXml, "testing XML" };
 	TestExecutive::TestStr ts4{ testCreateNewDbFromXmlFile, "testing XML" };
+	TestExecutive::TestStr ts5{ testStreamingRestore, "testing streaming restore" };
+	TestExecutive::TestStr ts6{ testStreamingSave, "testing streaming save" };
+	TestExecutive::TestStr ts7{ testSnapshot, "testing binary snapshot" };
+	TestExecutive::TestStr ts8{ testMappedDb, "testing memory-mapped db" };
+	TestExecutive::TestStr ts9{ testWal, "testing write-ahead log" };
 
 	ex.registerTest(ts1);
 	ex.registerTest(ts2);
 	ex.registerTest(ts3);
 	ex.registerTest(ts4);
+	ex.registerTest(ts5);
+	ex.registerTest(ts6);
+	ex.registerTest(ts7);
+	ex.registerTest(ts8);
+	ex.registerTest(ts9);
 
 	bool result = ex.doTests();
 	if (result == true)
@@ -1,6 +1,9 @@
+#pragma once
+#ifndef _PERSIST_H_
+#define _PERSIST_H_
 /////////////////////////////////////////////////////////////////////////////////////
 // Persist.h - store and retrieve NoSqlDb contents 								   //
-// ver 1.0                                                                         //
+// ver 1.4                                                                         //
 //                                                                                 //
 // Environment : C++ Console Application                                           //
 // Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
@@ -22,11 +25,16 @@
 *   ------------------------------------------------------------
 *   - createXml									: create XML representation of Database using XmlDocument
 *   - saveToFile								: saves db contents to file, using save
-*   - save										: save db contents to XML string
+*   - save										: save db contents to XML string or stream
 *   - restoreChildren							: retrive db children from XML string
 *   - restorePayLoad							: retrive db payload from XML string
-*   - restore									: retrive db contents from XML string
+*   - restore									: retrive db contents from XML string or stream
 *   - restoreFromFile							: restores db contents from file, using restore
+*
+* save and restore stream the XML through XmlWriter and XmlReader, one
+* dbRecord at a time, so neither builds an XmlDocument for the whole db.
+* Each record's payload still goes through T::toXmlElement and
+* T::fromXmlElement as a small XmlElement tree.
 
 * Required Files:
 * ---------------
@@ -37,6 +45,7 @@
 * XmlDocument.h, XmlDocument.cpp,
 * XmlElement.h, XmlElement.cpp,
 * XmlUtilities.h, XmlUtilities.cpp
+* XmlStream.h
 *
 * Build Process:
 * --------------
@@ -44,6 +53,18 @@
 *
 * Maintenance History:
 * --------------------
+* ver 1.4 : 18 Oct 2026
+* - restore moves each record into db with put, and throws if the
+*   stream ends inside a dbRecord instead of storing part of it
+* ver 1.3 : 18 Oct 2026
+* - createXml reads records through const references
+* ver 1.2 : 18 Oct 2026
+* - save writes records straight to a stream through XmlWriter, and
+*   saveToFile no longer builds the whole XML string first
+* ver 1.1 : 18 Oct 2026
+* - restore streams records through XmlReader instead of building an
+*   XmlDocument, and restoreFromFile no longer reads the file into a string
+* - restored records keep their children
 * ver 1.0 : 5 Feb 2018
 */
 
@@ -56,7 +77,10 @@
 #include "../XmlDocument/XmlElement.h"
 #include "../XmlUtilities/XmlUtilities.h"
 #include "../DateTime/DateTime.h"
+#include "XmlStream.h"
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 using namespace XmlProcessing;
 namespace NoSqlDb
@@ -79,7 +103,9 @@ namespace NoSqlDb
 		Persist(DbCore<T>& db) :db_(db) {}
 		void createXml();
 		Xml save();
+		void save(std::ostream& out);
 		void restore(const Xml& xml);
+		void restore(std::istream& in);
 		bool saveToFile(const std::string& fileSpec);
 		bool restoreFromFile(const std::string& fileSpec);
 		DbElement<PayLoad>::Children restoreChildren(SPtr pValueChild);
@@ -87,6 +113,8 @@ namespace NoSqlDb
 	private:
 		DbCore<T> &db_;
 		Xml xml_;
+		void restoreRecord(XmlReader& reader);
+		typename DbElement<T>::Children restoreChildren(XmlReader& reader);
 		std::string getTextBodyFromElement(SPtr sPtr);
 		std::string getTextBodyFromElement(SPtrs sPtrs);
 	};
@@ -101,7 +129,8 @@ namespace NoSqlDb
 		pDb->addAttrib("type", "testDb");
 		Sptr pDocElem = makeDocElement(pDb);
 		XmlDocument xDoc(pDocElem);
-		for (auto item : db_)
+		const DbCore<T>& db = db_;  // const iteration leaves db's indexes current
+		for (const auto& item : db)
 		{
 			Sptr pRecord = makeTaggedElement("dbRecord");
 			pDb->addChild(pRecord);
@@ -134,61 +163,63 @@ namespace NoSqlDb
 	}
 
 	//----< saves db contents to file, using save >--------------------
-
+	/*
+	*  - records are written through a large stream buffer as they are
+	*    serialized, so no copy of the db's XML is ever held in memory
+	*/
 	template<typename T>
 	bool Persist<T>::saveToFile(const std::string& fileSpec)
 	{
-		std::ofstream out(fileSpec);
+		std::vector<char> buffer(1 << 16);
+		std::ofstream out;
+		out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		out.open(fileSpec);
 		if (!out.good())
 			return false;
-		Persist<T> persist(db_);
-		Xml xml = persist.save();
-		out << xml;
+		save(out);
 		out.close();
-		return true;
+		return !out.fail();
 	}
 	//----< save db contents to XML string >---------------------------
 
 	template<typename T>
 	typename Persist<T>::Xml Persist<T>::save()
 	{
-		using Sptr = std::shared_ptr<AbstractXmlElement>;
-		Sptr pDb = makeTaggedElement("db");
-		pDb->addAttrib("type", "testDb");
-		Sptr pDocElem = makeDocElement(pDb);
-		XmlDocument xDoc(pDocElem);
-		// This works too.
-		// XmlProcessing::XmlDocument doc(XmlProcessing::makeDocElement(pDbRoot));
-		for (auto item : db_)
+		std::ostringstream out;
+		save(out);
+		return out.str();
+	}
+	//----< save db contents to XML stream >---------------------------
+	/*
+	*  - writes the same XML that XmlDocument::toString produced for the
+	*    tree save used to build, one dbRecord at a time
+	*/
+	template<typename T>
+	void Persist<T>::save(std::ostream& out)
+	{
+		XmlWriter writer(out);
+		writer.start("db", XmlWriter::Attributes{ { "type", "testDb" } });
+		const DbCore<T>& db = db_;  // const iteration leaves db's indexes current
+		for (const auto& item : db)
 		{
-			Sptr pRecord = makeTaggedElement("dbRecord");
-			pDb->addChild(pRecord);
-			Sptr pKey = makeTaggedElement("key", item.first);
-			pRecord->addChild(pKey);
-			Sptr pValue = makeTaggedElement("value");
-			pRecord->addChild(pValue);
-			Sptr pName = makeTaggedElement("name", item.second.name());
-			pValue->addChild(pName);
-			Sptr pDescrip = makeTaggedElement("description", item.second.descrip());
-			pValue->addChild(pDescrip);
-			Sptr pDate = makeTaggedElement("date", item.second.dateTime());
-			pValue->addChild(pDate);
-			SPtr pChildren = XmlProcessing::makeTaggedElement("children");
-			Keys childKeys = item.second.children();
-			for (Key child : childKeys)
-			{
-				SPtr pChild = XmlProcessing::makeTaggedElement("childKey", static_cast<std::string>(child));
-				pChildren->addChild(pChild);
-			}
-
-			pValue->addChild(pChildren);
-			Sptr pPayLoad = item.second.payLoad().toXmlElement();
-			pValue->addChild(pPayLoad);
+			const DbElement<T>& elem = item.second;
+			writer.start("dbRecord");
+			writer.element("key", item.first);
+			writer.start("value");
+			writer.element("name", elem.name());
+			writer.element("description", elem.descrip());
+			writer.element("date", std::string(elem.dateTime()));
+			writer.start("children");
+			for (const Key& child : elem.children())
+				writer.element("childKey", child);
+			writer.end();
+			writer.element(elem.payLoad().toXmlElement());
+			writer.end();
+			writer.end();
 		}
-		return xDoc.toString();
+		writer.end();
 	}
 
-
 	//----< retrive db children from XML string >---------------------------
 	/*
 	* Private helper function - provides safe extraction of element text
@@ -207,59 +238,104 @@ namespace NoSqlDb
 	}
 
 	//----< retrive db contents from XML string >----------------------
+
+	template<typename T>
+	void Persist<T>::restore(const Xml& xml)
+	{
+		std::istringstream in(xml);
+		restore(in);
+	}
+
+	//----< retrive db contents from XML stream >----------------------
 	/*
-	* Private helper function - provides safe extraction of element text
-	* from single element pointer.
+	*  - inserts each dbRecord as soon as it has been read, so memory use
+	*    is bounded by the largest record, not the size of the db
 	*/
 	template<typename T>
-	void Persist<T>::restore(const Xml& xml)
+	void Persist<T>::restore(std::istream& in)
 	{
-		std::cout << "\n  Building a new Db from XmlDocument";
-		std::cout << "\n ----------------------------------";
-		using Sptr = std::shared_ptr<XmlProcessing::AbstractXmlElement>;
-		XmlDocument doc(xml, XmlDocument::str);
-		std::vector<Sptr> records = doc.descendents("dbRecord").select();
-		for (auto pRecord : records)
+		std::cout << "\n  Building a new Db from XML";
+		std::cout << "\n ---------------------------";
+		XmlReader reader(in);
+		XmlReader::Event event;
+		while ((event = reader.next()) != XmlReader::done)
 		{
-			Key key;
-			DbElement<PayLoad> elem;
-			std::vector<Sptr> pChildren = pRecord->children();
-			for (auto pChild : pChildren)
+			if (event == XmlReader::startTag && reader.tag() == "dbRecord")
+				restoreRecord(reader);
+		}
+	}
+
+	//----< read one dbRecord, whose start tag was just read, into db >--
+	/*
+	*  - throws if the stream ends before the record's end tag, so a
+	*    truncated file never leaves part of a record in db
+	*/
+	template<typename T>
+	void Persist<T>::restoreRecord(XmlReader& reader)
+	{
+		Key key;
+		DbElement<T> elem;
+		bool complete = false;
+		XmlReader::Event event;
+		while ((event = reader.next()) != XmlReader::done)
+		{
+			if (event == XmlReader::endTag)
 			{
-				// record's children are key and value
-				if (pChild->tag() == "key")
-				{
-					// get value of TextElement child
-					key = pChild->children()[0]->value();
-				}
-				else
+				if (reader.tag() == "dbRecord")
 				{
-					// value represents a MockDbElem with children name and description
-					std::vector<Sptr> pValueChildren = pChild->children();
-					for (auto pValueChild : pValueChildren)
-					{
-						if (pValueChild->tag() == "name")
-							elem.name(pValueChild->children()[0]->value());
-						if (pValueChild->tag() == "description")
-							elem.descrip(pValueChild->children()[0]->value());
-						if (pValueChild->tag() == "date")
-							elem.dateTime(pValueChild->children()[0]->value());
-						if (pValueChild->tag() == "children")
-						{
-							DbElement<PayLoad>::Children children;
-							restoreChildren(pValueChild);
-							elem.children(children);
-						}
-						if (pValueChild->tag() == "payload")
-						{
-							PayLoad const payload = PayLoad::fromXmlElement(pValueChild);
-							elem.payLoad(payload);
-						}
-					}
+					complete = true;
+					break;
 				}
+				continue;  // end of value
 			}
-			db_[key] = elem;
+			if (event != XmlReader::startTag)
+				continue;
+
+			// record's children are key and value, value holds the rest
+			const std::string& tag = reader.tag();
+			if (tag == "value")
+				continue;
+			if (tag == "key")
+				key = reader.readText();
+			else if (tag == "name")
+				elem.name(reader.readText());
+			else if (tag == "description")
+				elem.descrip(reader.readText());
+			else if (tag == "date")
+			{
+				std::string date = reader.readText();
+				if (date.size() > 0)
+					elem.dateTime(date);
+			}
+			else if (tag == "children")
+				elem.children(restoreChildren(reader));
+			else if (tag == "payload")
+				elem.payLoad(T::fromXmlElement(reader.readElement()));
+			else
+				reader.skip();
 		}
+		if (!complete)
+			throw(std::exception("XML stream ends inside a dbRecord"));
+		db_.put(std::move(key), std::move(elem));
+	}
+
+	//----< read childKeys up to the end of children element >---------
+
+	template<typename T>
+	typename DbElement<T>::Children Persist<T>::restoreChildren(XmlReader& reader)
+	{
+		typename DbElement<T>::Children children;
+		XmlReader::Event event;
+		while ((event = reader.next()) != XmlReader::done && event != XmlReader::endTag)
+		{
+			if (event != XmlReader::startTag)
+				continue;
+			if (reader.tag() == "childKey")
+				children.push_back(reader.readText());
+			else
+				reader.skip();
+		}
+		return children;
 	}
 
 	//----< restores db contents from file, using restore >------------
@@ -267,38 +343,16 @@ namespace NoSqlDb
 	template<typename T>
 	bool Persist<T>::restoreFromFile(const std::string& fileSpec)
 	{
-		//std::string newFS = "C:\\Users\\James\\Desktop\\InstrSolProject1S2017\\Project1.xml";
 		std::ifstream in(fileSpec);
 		if (!in.good())
 		{
 			std::cout << "\n  failed to open file";
 			return false;
 		}
-		Xml xml;
-
-		// build XML string from file
-
-		while (in.good())
-		{
-			char ch = in.get();
-
-			/////////////////////////////////////////////////////
-			// This code removes whitespace from XML contents
-			// but is unnecessart and adds a small CPU load.
-			// I left it here because I intent to use it in
-			// another package, for display.
-			/////////////////////////////////////////////////////
-			// if (ch == '\n' || ch == '\t' || ch == ' ')
-			//   continue;
-			/////////////////////////////////////////////////////
-
-			if (!in.good())
-				break;
-			xml += ch;
-		}
+		restore(in);
 		in.close();
-
-		restore(xml);
 		return true;
 	}
 }
+
+#endif
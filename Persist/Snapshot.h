@@ -0,0 +1,242 @@
+#pragma once
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// Snapshot.h - store and retrieve NoSqlDb contents in a compact binary format     //
+// ver 1.6                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines a single class, Snapshot, that saves db contents
+* to, and restores them from, a binary snapshot.  It holds the same
+* information as the XML written by Persist - key, name, description,
+* date, children, and payload of every record - but is much smaller and
+* much faster to read back.
+*
+* A snapshot is the four bytes "NSDB", a format version, and the records
+* in checksummed blocks, written with BinaryWriter:
+*   key, name, description, dateTime ticks, child count, children, payload
+* Keys, children, and payload categories go through BinaryWriter's string
+* table, so a key used as a child elsewhere is stored only once.
+*
+* Payloads are written with T::toBinary(BinaryWriter&) and read with
+* static T::fromBinary(BinaryReader&), just as Persist uses
+* T::toXmlElement and T::fromXmlElement.
+*
+*   ----------------------------------------------------------
+*   - save										: save db contents to a binary stream
+*   - saveToFile								: saves db contents to file, using save
+*   - restore									: retrive db contents from a binary stream
+*   - restoreFromFile							: restores db contents from file, using restore
+*   - xmlToSnapshot								: converts a Persist XML file into a snapshot file
+*   - snapshotToXml								: converts a snapshot file into a Persist XML file
+*   - writeRecord, readRecord					: encode and decode one record, also used by Wal
+*
+* Restoring into a db built with a DbArena takes each record's node
+* from the arena, a chunk at a time.  The strings and vectors a record
+* owns are still allocated from the heap, one at a time.
+*
+* Required Files:
+* ---------------
+* Snapshot.h, BinaryStream.h
+* Persist.h, Persist.cpp
+* DbCore.h, DbCore.cpp
+* DateTime.h, DateTime.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.6 : 18 Oct 2026
+* - restore checks a block for trailing bytes before loading its records
+* ver 1.5 : 18 Oct 2026
+* - format version 2, whose block CRCs cover each block's header
+* ver 1.4 : 18 Oct 2026
+* - writeRecord reads children without copying them
+* ver 1.3 : 18 Oct 2026
+* - restore hands each block's records to DbCore::load
+* ver 1.2 : 18 Oct 2026
+* - restore reserves room a block at a time and moves records into db
+* ver 1.1 : 18 Oct 2026
+* - record encoding moved into writeRecord and readRecord for Wal
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include "../DbCore/DbCore.h"
+#include "../DateTime/DateTime.h"
+#include "BinaryStream.h"
+#include "Persist.h"
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////
+	// Snapshot class holds a reference to db and uses
+	// that to save and restore the db in binary form.
+
+	template<typename T>
+	class Snapshot
+	{
+	public:
+		using Key = std::string;
+		static const uint32_t version = 2;
+
+		Snapshot(DbCore<T>& db) : db_(db) {}
+		void save(std::ostream& out);
+		bool saveToFile(const std::string& fileSpec);
+		void restore(std::istream& in);
+		bool restoreFromFile(const std::string& fileSpec);
+		static bool xmlToSnapshot(const std::string& xmlSpec, const std::string& snapshotSpec);
+		static bool snapshotToXml(const std::string& snapshotSpec, const std::string& xmlSpec);
+		static void writeRecord(BinaryWriter& writer, const Key& key, const DbElement<T>& elem);
+		static void readRecord(BinaryReader& reader, Key& key, DbElement<T>& elem);
+	private:
+		DbCore<T>& db_;
+	};
+
+	//----< save db contents to a binary stream >--------------------------
+
+	template<typename T>
+	void Snapshot<T>::save(std::ostream& out)
+	{
+		out.write("NSDB", 4);
+		BinaryWriter::fixed32(out, version);
+		BinaryWriter writer(out);
+		const DbCore<T>& db = db_;  // const iteration leaves db's indexes current
+		for (const auto& item : db)
+		{
+			writeRecord(writer, item.first, item.second);
+			writer.endRecord();
+		}
+		writer.close();
+	}
+
+	//----< write one record, without ending it >------------------------
+
+	template<typename T>
+	void Snapshot<T>::writeRecord(BinaryWriter& writer, const Key& key, const DbElement<T>& elem)
+	{
+		writer.ref(key);
+		writer.string(elem.name());
+		writer.string(elem.descrip());
+		writer.number(elem.dateTime().ticks());
+		const typename DbElement<T>::Children& children = elem.children();
+		writer.number(children.size());
+		for (const Key& child : children)
+			writer.ref(child);
+		elem.payLoad().toBinary(writer);
+	}
+
+	//----< saves db contents to file, using save >----------------------
+
+	template<typename T>
+	bool Snapshot<T>::saveToFile(const std::string& fileSpec)
+	{
+		std::ofstream out(fileSpec, std::ios::binary);
+		if (!out.good())
+			return false;
+		save(out);
+		out.close();
+		return !out.fail();
+	}
+
+	//----< retrive db contents from a binary stream >---------------------
+	/*
+	*  - throws if the stream is not a snapshot, has a version this code
+	*    does not read, or fails a block's CRC check
+	*  - a block's record count is checked against its length, and its
+	*    length against the stream, before records are sized from them
+	*/
+	template<typename T>
+	void Snapshot<T>::restore(std::istream& in)
+	{
+		char magic[4] = { 0, 0, 0, 0 };
+		in.read(magic, 4);
+		if (!in.good() || std::memcmp(magic, "NSDB", 4) != 0)
+			throw(std::exception("not a NoSqlDb snapshot"));
+		if (BinaryReader::fixed32(in) != version)
+			throw(std::exception("unsupported snapshot version"));
+
+		BinaryReader reader(in);
+		while (reader.nextBlock())
+		{
+			typename DbCore<T>::Records records(reader.records());
+			for (auto& record : records)
+				readRecord(reader, record.first, record.second);
+			if (!reader.atBlockEnd())
+				throw(std::exception("snapshot block has trailing bytes"));
+			db_.load(std::move(records));
+		}
+	}
+
+	//----< read one record written by writeRecord >--------------------
+
+	template<typename T>
+	void Snapshot<T>::readRecord(BinaryReader& reader, Key& key, DbElement<T>& elem)
+	{
+		key = reader.ref();
+		elem.name(reader.string());
+		elem.descrip(reader.string());
+		std::chrono::seconds ticks(static_cast<std::chrono::seconds::rep>(reader.number()));
+		elem.dateTime(DateTime(DateTime::TimePoint(ticks)));
+		size_t count = static_cast<size_t>(reader.number());
+		for (size_t i = 0; i < count; ++i)
+			elem.children().push_back(reader.ref());
+		elem.payLoad(T::fromBinary(reader));
+	}
+
+	//----< restores db contents from file, using restore >--------------
+
+	template<typename T>
+	bool Snapshot<T>::restoreFromFile(const std::string& fileSpec)
+	{
+		std::ifstream in(fileSpec, std::ios::binary);
+		if (!in.good())
+		{
+			std::cout << "\n  failed to open file";
+			return false;
+		}
+		restore(in);
+		return true;
+	}
+
+	//----< converts a Persist XML file into a snapshot file >-----------
+
+	template<typename T>
+	bool Snapshot<T>::xmlToSnapshot(const std::string& xmlSpec, const std::string& snapshotSpec)
+	{
+		DbCore<T> db;
+		Persist<T> persist(db);
+		if (!persist.restoreFromFile(xmlSpec))
+			return false;
+		return Snapshot<T>(db).saveToFile(snapshotSpec);
+	}
+
+	//----< converts a snapshot file into a Persist XML file >-----------
+
+	template<typename T>
+	bool Snapshot<T>::snapshotToXml(const std::string& snapshotSpec, const std::string& xmlSpec)
+	{
+		DbCore<T> db;
+		if (!Snapshot<T>(db).restoreFromFile(snapshotSpec))
+			return false;
+		return Persist<T>(db).saveToFile(xmlSpec);
+	}
+}
+
+#endif
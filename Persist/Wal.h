@@ -0,0 +1,533 @@
+#pragma once
+#ifndef _WAL_H_
+#define _WAL_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// Wal.h - write-ahead log of db changes, between snapshots                        //
+// ver 1.3                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines a class, Wal, that makes db changes durable
+* without rewriting the whole db.  Changes made through Wal are applied
+* to the db and appended to a log file.  The db is restored by loading
+* the last snapshot and replaying the log, and compact writes a new
+* snapshot and empties the log.
+*
+* - put, addChild, deleteChild, and deleteRecord change the db the way
+*   operator[] assignment and the DbCore methods of the same names do.
+*   Changes made to the db directly are not logged.
+* - entries are collected until commit, or until groupSize entries are
+*   pending, and then written with a single write as one checksummed
+*   BinaryWriter block
+* - the log is flushed to disk (fsync or _commit) once every syncEvery
+*   commits, 1 by default.  0 leaves flushing to the OS.
+* - once the log grows past compactAt bytes, commit compacts it
+*
+* The log records the state a change leaves behind - a whole record, a
+* parent's whole child list, or a deletion - not the change itself, so
+* replaying entries that are already in the snapshot leaves the db as
+* it was.  A crash between writing a snapshot and emptying the log is
+* therefore harmless.  A torn last block, from a crash during a write,
+* fails its CRC check, and recover cuts it off.
+*
+* LogFile is the append-only file underneath, using the POSIX calls, or
+* their <io.h> equivalents on Windows.
+*
+*   ----------------------------------------------------------
+*   Wal
+*   - recover									: restores snapshot, replays log, and opens log for appending
+*   - put										: sets the record for key, like db[key] = elem
+*   - addChild, deleteChild, deleteRecord		: as DbCore's methods
+*   - commit									: writes pending entries to the log
+*   - sync										: flushes the log to disk
+*   - compact									: writes a new snapshot and empties the log
+*   - groupSize, syncEvery, compactAt			: batching and compaction settings
+*   - pending, logSize							: entries not yet committed, bytes in log
+*
+* Required Files:
+* ---------------
+* Wal.h, Snapshot.h, BinaryStream.h
+* DbCore.h, DbCore.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.3 : 18 Oct 2026
+* - put and recover store records with DbCore::put, which hands out
+*   no reference to them
+* ver 1.2 : 18 Oct 2026
+* - a failed commit cuts off what it wrote, and recover rejects a
+*   block with bytes its entries do not account for
+* ver 1.1 : 18 Oct 2026
+* - logChildren reads the child list without copying it
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include "../DbCore/DbCore.h"
+#include "BinaryStream.h"
+#include "Snapshot.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#include <share.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// LogFile class
+	// - file opened for appending, with explicit flush to disk
+
+	class LogFile
+	{
+	public:
+		LogFile() = default;
+		LogFile(const LogFile&) = delete;
+		LogFile& operator=(const LogFile&) = delete;
+		~LogFile() { close(); }
+		bool open(const std::string& fileSpec);
+		void close();
+		bool isOpen() const { return fd_ >= 0; }
+		bool append(const std::string& bytes);
+		bool sync();
+		bool truncate(uint64_t size);
+		uint64_t size() const { return size_; }
+	private:
+		int fd_ = -1;
+		uint64_t size_ = 0;
+	};
+
+	//----< open fileSpec for appending, creating it if needed >---------
+
+	inline bool LogFile::open(const std::string& fileSpec)
+	{
+		close();
+#ifdef _WIN32
+		_sopen_s(&fd_, fileSpec.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+			_SH_DENYWR, _S_IREAD | _S_IWRITE);
+		if (fd_ < 0)
+			return false;
+		size_ = static_cast<uint64_t>(_filelengthi64(fd_));
+#else
+		fd_ = ::open(fileSpec.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (fd_ < 0)
+			return false;
+		struct stat info;
+		size_ = fstat(fd_, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+		return true;
+	}
+
+	//----< close the file, if open >------------------------------------
+
+	inline void LogFile::close()
+	{
+		if (fd_ < 0)
+			return;
+#ifdef _WIN32
+		_close(fd_);
+#else
+		::close(fd_);
+#endif
+		fd_ = -1;
+		size_ = 0;
+	}
+
+	//----< append bytes with as few write calls as the OS allows >------
+
+	inline bool LogFile::append(const std::string& bytes)
+	{
+		size_t done = 0;
+		while (done < bytes.size())
+		{
+#ifdef _WIN32
+			int n = _write(fd_, bytes.data() + done, static_cast<unsigned>(bytes.size() - done));
+#else
+			ssize_t n = ::write(fd_, bytes.data() + done, bytes.size() - done);
+#endif
+			if (n <= 0)
+				return false;
+			done += static_cast<size_t>(n);
+		}
+		size_ += bytes.size();
+		return true;
+	}
+
+	//----< flush the file's data to disk >------------------------------
+
+	inline bool LogFile::sync()
+	{
+#ifdef _WIN32
+		return _commit(fd_) == 0;
+#else
+		return fsync(fd_) == 0;
+#endif
+	}
+
+	//----< cut the file back to size bytes >----------------------------
+
+	inline bool LogFile::truncate(uint64_t size)
+	{
+#ifdef _WIN32
+		bool ok = _chsize_s(fd_, static_cast<__int64>(size)) == 0;
+#else
+		bool ok = ftruncate(fd_, static_cast<off_t>(size)) == 0;
+#endif
+		if (ok)
+			size_ = size;
+		return ok;
+	}
+
+	//----< replace file to with file from, in one step >----------------
+
+	inline bool replaceFile(const std::string& from, const std::string& to)
+	{
+#ifdef _WIN32
+		return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// Wal class
+	// - applies changes to db and logs them
+	// - not thread safe, like DbCore
+
+	template<typename T>
+	class Wal
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<Key>;
+		enum Op { putOp = 1, childrenOp = 2, eraseOp = 3 };
+		struct Entry
+		{
+			uint64_t op = 0;
+			Key key;
+			DbElement<T> elem;
+			Keys children;
+		};
+
+		Wal(DbCore<T>& db, const std::string& logSpec, const std::string& snapshotSpec)
+			: db_(db), logSpec_(logSpec), snapshotSpec_(snapshotSpec) {}
+		~Wal();
+		bool recover();
+
+		void put(const Key& key, const DbElement<T>& elem);
+		bool addChild(const Key& parentKey, const Key& childKey);
+		bool deleteChild(const Key& parentKey, const Key& childKey);
+		bool deleteRecord(const Key& key);
+
+		void commit();
+		void sync();
+		bool compact();
+
+		void groupSize(size_t entries) { groupSize_ = entries > 0 ? entries : 1; }
+		void syncEvery(size_t commits) { syncEvery_ = commits; }
+		void compactAt(uint64_t bytes) { compactAt_ = bytes; }
+		size_t pending() const { return pending_; }
+		uint64_t logSize() const { return log_.size(); }
+	private:
+		BinaryWriter& writer();
+		void logChildren(const Key& parentKey);
+		void endEntry();
+		void replay(BinaryReader& reader);
+
+		DbCore<T>& db_;
+		std::string logSpec_;
+		std::string snapshotSpec_;
+		LogFile log_;
+		std::ostringstream buffer_;
+		std::unique_ptr<BinaryWriter> writer_;
+		size_t pending_ = 0;
+		size_t groupSize_ = 1;
+		size_t syncEvery_ = 1;
+		size_t unsynced_ = 0;
+		uint64_t compactAt_ = 0;
+	};
+
+	//----< commit what is pending, swallowing errors >------------------
+
+	template<typename T>
+	Wal<T>::~Wal()
+	{
+		try
+		{
+			commit();
+			if (unsynced_ > 0)
+				sync();
+		}
+		catch (std::exception&) {}
+	}
+
+	//----< load snapshot, replay log, and open log for appending >------
+	/*
+	*  - either file may be missing, for a new db
+	*  - stops at the first block that is torn, fails its CRC, or holds
+	*    bytes its entries do not account for, and cuts the log back to
+	*    the end of the last good block
+	*/
+	template<typename T>
+	bool Wal<T>::recover()
+	{
+		std::ifstream snapshot(snapshotSpec_, std::ios::binary);
+		if (snapshot.good())
+			Snapshot<T>(db_).restore(snapshot);
+		snapshot.close();
+
+		uint64_t good = 0;
+		bool torn = false;
+		std::ifstream in(logSpec_, std::ios::binary);
+		while (in.good() && in.peek() != EOF)
+		{
+			try
+			{
+				BinaryReader reader(in);
+				if (!reader.nextBlock())
+					break;
+				replay(reader);
+				good = static_cast<uint64_t>(in.tellg());
+			}
+			catch (std::exception&)
+			{
+				torn = true;
+				break;
+			}
+		}
+		in.close();
+
+		if (!log_.open(logSpec_))
+			return false;
+		if (torn || log_.size() != good)
+			return log_.truncate(good) && log_.sync();
+		return true;
+	}
+
+	//----< apply the entries of one committed block to db >-------------
+	/*
+	*  - the whole block is decoded before any entry is applied, so a
+	*    block that is rejected, like a snapshot with trailing bytes,
+	*    leaves db as it was
+	*/
+	template<typename T>
+	void Wal<T>::replay(BinaryReader& reader)
+	{
+		std::vector<Entry> entries;
+		for (size_t i = 0; i < reader.records(); ++i)
+		{
+			Entry entry;
+			entry.op = reader.number();
+			if (entry.op == putOp)
+				Snapshot<T>::readRecord(reader, entry.key, entry.elem);
+			else if (entry.op == childrenOp)
+			{
+				entry.key = reader.ref();
+				size_t count = static_cast<size_t>(reader.number());
+				for (size_t j = 0; j < count; ++j)
+					entry.children.push_back(reader.ref());
+			}
+			else if (entry.op == eraseOp)
+				entry.key = reader.ref();
+			else
+				throw(std::exception("unknown log entry"));
+			entries.push_back(std::move(entry));
+		}
+		if (!reader.atBlockEnd())
+			throw(std::exception("log block has trailing bytes"));
+
+		for (Entry& entry : entries)
+		{
+			if (entry.op == putOp)
+				db_.put(std::move(entry.key), std::move(entry.elem));
+			else if (entry.op == childrenOp)
+			{
+				if (db_.contains(entry.key))
+					db_[entry.key].children(entry.children);
+			}
+			else
+				db_.deleteRecord(entry.key);
+		}
+	}
+
+	//----< writer for the entries of the next commit >------------------
+	/*
+	*  - each commit gets its own writer, so every block carries its own
+	*    string table and can be replayed on its own
+	*/
+	template<typename T>
+	BinaryWriter& Wal<T>::writer()
+	{
+		if (!writer_)
+			writer_.reset(new BinaryWriter(buffer_, SIZE_MAX));
+		return *writer_;
+	}
+
+	//----< count an entry, committing once a group is full >------------
+
+	template<typename T>
+	void Wal<T>::endEntry()
+	{
+		writer().endRecord();
+		if (++pending_ >= groupSize_)
+			commit();
+	}
+
+	//----< set the record for key, logging the whole record >-----------
+
+	template<typename T>
+	void Wal<T>::put(const Key& key, const DbElement<T>& elem)
+	{
+		db_.put(key, elem);
+		writer().number(putOp);
+		Snapshot<T>::writeRecord(writer(), key, elem);
+		endEntry();
+	}
+
+	//----< log parent's child list as it is now >-----------------------
+
+	template<typename T>
+	void Wal<T>::logChildren(const Key& parentKey)
+	{
+		const DbCore<T>& db = db_;
+		const typename DbElement<T>::Children& children = db[parentKey].children();
+		writer().number(childrenOp);
+		writer().ref(parentKey);
+		writer().number(children.size());
+		for (const Key& child : children)
+			writer().ref(child);
+		endEntry();
+	}
+
+	//----< add child to parent, logging parent's new child list >-------
+
+	template<typename T>
+	bool Wal<T>::addChild(const Key& parentKey, const Key& childKey)
+	{
+		if (!db_.addChild(parentKey, childKey))
+			return false;
+		logChildren(parentKey);
+		return true;
+	}
+
+	//----< remove child from parent, logging parent's new child list >--
+
+	template<typename T>
+	bool Wal<T>::deleteChild(const Key& parentKey, const Key& childKey)
+	{
+		if (!db_.deleteChild(parentKey, childKey))
+			return false;
+		logChildren(parentKey);
+		return true;
+	}
+
+	//----< delete record, logging the deletion >------------------------
+	/*
+	*  - replay calls deleteRecord too, so parents lose the key again
+	*/
+	template<typename T>
+	bool Wal<T>::deleteRecord(const Key& key)
+	{
+		if (!db_.deleteRecord(key))
+			return false;
+		writer().number(eraseOp);
+		writer().ref(key);
+		endEntry();
+		return true;
+	}
+
+	//----< append pending entries to the log as one block >-------------
+	/*
+	*  - a write that fails part way is cut off, so the next commit's
+	*    block does not follow a torn one
+	*/
+	template<typename T>
+	void Wal<T>::commit()
+	{
+		if (pending_ == 0)
+			return;
+		if (!log_.isOpen())
+			throw(std::exception("log is not open, call recover first"));
+		writer_->flush();
+		writer_.reset();
+		std::string block = buffer_.str();
+		buffer_.str("");
+		pending_ = 0;
+		uint64_t before = log_.size();
+		if (!log_.append(block))
+		{
+			log_.truncate(before);
+			throw(std::exception("log write failed"));
+		}
+		if (syncEvery_ > 0 && ++unsynced_ >= syncEvery_)
+			sync();
+		if (compactAt_ > 0 && log_.size() >= compactAt_)
+			compact();
+	}
+
+	//----< flush committed entries to disk >----------------------------
+
+	template<typename T>
+	void Wal<T>::sync()
+	{
+		if (!log_.sync())
+			throw(std::exception("log sync failed"));
+		unsynced_ = 0;
+	}
+
+	//----< write a new snapshot and empty the log >---------------------
+	/*
+	*  - the snapshot is written beside the old one and renamed over it
+	*    once it is on disk, so there is always one complete snapshot
+	*/
+	template<typename T>
+	bool Wal<T>::compact()
+	{
+		commit();
+		std::string temp = snapshotSpec_ + ".tmp";
+		if (!Snapshot<T>(db_).saveToFile(temp))
+			return false;
+		LogFile written;
+		if (!written.open(temp) || !written.sync())
+			return false;
+		written.close();
+		if (!replaceFile(temp, snapshotSpec_))
+			return false;
+		if (!log_.truncate(0))
+			return false;
+		sync();
+		return true;
+	}
+}
+
+#endif
@@ -0,0 +1,363 @@
+#pragma once
+#ifndef _XMLSTREAM_H_
+#define _XMLSTREAM_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// XmlStream.h - read and write XML markup as a stream, without a document         //
+// ver 1.2                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package provides two classes:
+* - XmlReader, a pull parser that walks XML markup held in a std::istream
+*   and reports start tags, end tags, and text one at a time.  It reads
+*   through the stream's buffer, so memory use does not grow with the
+*   size of the input.
+* - XmlWriter, which writes elements to a std::ostream as they are
+*   opened and closed, in exactly the layout XmlDocument::toString
+*   produces, without holding any of them in memory.
+*
+* Persist uses XmlReader to restore a db one dbRecord at a time, instead
+* of parsing the whole file into an XmlDocument first, and XmlWriter to
+* save one the same way.
+*
+* Text is reported the way XmlParser reports it, with leading and
+* trailing whitespace removed.  Declarations, processing instructions,
+* and comments are skipped, as are attributes.
+*
+*   ----------------------------------------------------------
+*   - next										: advances to the next start tag, end tag, or text
+*   - tag										: name of the current start or end tag
+*   - text										: body of the current text
+*   - readText									: text body of the current element, consuming its end tag
+*   - readElement								: current element as an XmlElement tree, consuming its end tag
+*   - skip										: discards the rest of the current element
+*
+*   XmlWriter
+*   - start										: opens an element
+*   - end										: closes the most recently opened element
+*   - text										: writes a text body
+*   - element									: writes a whole element, from a tag and text or from an XmlElement
+*
+* Like XmlElement, XmlWriter writes text and attribute values as given,
+* without escaping them.
+*
+* Required Files:
+* ---------------
+* XmlStream.h
+* XmlElement.h, XmlElement.cpp
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.2 : 18 Oct 2026
+* - element(SPtr) writes the tree through an XmlOut on the stream, at
+*   the depth of the open elements
+* ver 1.1 : 18 Oct 2026
+* - added XmlWriter
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <memory>
+#include <vector>
+#include <cctype>
+#include <cstdio>
+#include "../XmlDocument/XmlElement.h"
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// XmlReader class
+	// - pull parser over a std::istream
+	// - a self-closing tag, <tag/>, is reported as a start tag followed
+	//   by an end tag
+
+	class XmlReader
+	{
+	public:
+		using SPtr = std::shared_ptr<XmlProcessing::AbstractXmlElement>;
+		enum Event { startTag, endTag, content, done };
+
+		XmlReader(std::istream& in) : in_(in.rdbuf()) {}
+		Event next();
+		const std::string& tag() const { return tag_; }
+		const std::string& text() const { return text_; }
+		std::string readText();
+		SPtr readElement();
+		void skip();
+	private:
+		int get() { return in_->sbumpc(); }
+		int peek() { return in_->sgetc(); }
+		static bool isSpace(int ch) { return ch != EOF && isspace(ch) != 0; }
+		void skipPast(const std::string& terminator);
+		void readTag();
+		void trimText();
+
+		std::streambuf* in_;
+		std::string tag_;
+		std::string text_;
+		bool pendingEnd_ = false;
+	};
+
+	//----< advance to the next start tag, end tag, or text >------------
+
+	inline XmlReader::Event XmlReader::next()
+	{
+		if (pendingEnd_)
+		{
+			pendingEnd_ = false;
+			return endTag;
+		}
+		while (true)
+		{
+			text_.clear();
+			while (isSpace(peek()))
+				get();
+			while (peek() != EOF && peek() != '<')
+				text_ += static_cast<char>(get());
+			if (!text_.empty())
+			{
+				trimText();
+				return content;
+			}
+			if (get() == EOF)
+				return done;
+
+			int ch = peek();
+			if (ch == '?')
+			{
+				skipPast("?>");
+				continue;
+			}
+			if (ch == '!')
+			{
+				get();
+				if (peek() == '-')
+					skipPast("-->");
+				else
+					skipPast(">");
+				continue;
+			}
+			if (ch == '/')
+			{
+				get();
+				readTag();
+				return endTag;
+			}
+			readTag();
+			return startTag;
+		}
+	}
+
+	//----< read tag name, skipping attributes, through closing '>' >----
+
+	inline void XmlReader::readTag()
+	{
+		tag_.clear();
+		int ch;
+		while ((ch = peek()) != EOF && ch != '>' && ch != '/' && !isSpace(ch))
+			tag_ += static_cast<char>(get());
+
+		int prev = 0;
+		while ((ch = get()) != EOF && ch != '>')
+		{
+			if (ch == '\"' || ch == '\'')
+			{
+				int quote = ch;
+				while ((ch = get()) != EOF && ch != quote)
+					;
+			}
+			prev = ch;
+		}
+		if (ch == EOF)
+			throw(std::exception(("unterminated tag <" + tag_).c_str()));
+		pendingEnd_ = (prev == '/');
+	}
+
+	//----< discard input up to and including terminator >---------------
+
+	inline void XmlReader::skipPast(const std::string& terminator)
+	{
+		size_t matched = 0;
+		int ch;
+		while (matched < terminator.size() && (ch = get()) != EOF)
+		{
+			if (ch == terminator[matched])
+				++matched;
+			else
+				matched = (ch == terminator[0]) ? 1 : 0;
+		}
+	}
+
+	//----< remove trailing whitespace, as XmlParser does >--------------
+
+	inline void XmlReader::trimText()
+	{
+		size_t last = text_.size();
+		while (last > 0 && isSpace(static_cast<unsigned char>(text_[last - 1])))
+			--last;
+		text_.erase(last);
+	}
+
+	//----< text body of the element whose start tag was just read >----
+	/*
+	*  - consumes the element's end tag
+	*  - returns an empty string for an empty element
+	*/
+	inline std::string XmlReader::readText()
+	{
+		std::string body;
+		Event event = next();
+		if (event == content)
+		{
+			body = text_;
+			event = next();
+		}
+		if (event != endTag)
+			throw(std::exception("expected text-only element"));
+		return body;
+	}
+
+	//----< element whose start tag was just read, as an XmlElement >----
+	/*
+	*  - used for parts of a record, like payloads, that are restored
+	*    from XmlElements
+	*/
+	inline XmlReader::SPtr XmlReader::readElement()
+	{
+		SPtr pElem = XmlProcessing::makeTaggedElement(tag_);
+		Event event;
+		while ((event = next()) != done)
+		{
+			if (event == endTag)
+				return pElem;
+			if (event == content)
+				pElem->addChild(XmlProcessing::makeTextElement(text_));
+			else
+				pElem->addChild(readElement());
+		}
+		throw(std::exception(("unterminated element <" + pElem->tag()).c_str()));
+	}
+
+	//----< discard the rest of the element whose start tag was read >---
+
+	inline void XmlReader::skip()
+	{
+		size_t depth = 1;
+		Event event;
+		while (depth > 0 && (event = next()) != done)
+		{
+			if (event == startTag)
+				++depth;
+			else if (event == endTag)
+				--depth;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////
+	// XmlWriter class
+	// - writes XML to a std::ostream as elements are opened and closed
+	// - holds only the tags of the open elements
+
+	class XmlWriter
+	{
+	public:
+		using SPtr = std::shared_ptr<XmlProcessing::AbstractXmlElement>;
+		using Attributes = XmlProcessing::AbstractXmlElement::Attributes;
+
+		XmlWriter(std::ostream& out) : out_(out) {}
+		void start(const std::string& tag, const Attributes& attribs = Attributes());
+		void end();
+		void text(const std::string& body);
+		void element(const std::string& tag, const std::string& body);
+		void element(SPtr pElem);
+		size_t depth() const { return open_.size(); }
+	private:
+		static const size_t tabSize = 2;  // same as XmlElement's
+		void indent(size_t level);
+
+		std::ostream& out_;
+		std::vector<std::string> open_;
+	};
+
+	//----< start a line indented as XmlElement::toString would >--------
+
+	inline void XmlWriter::indent(size_t level)
+	{
+		static const std::string spaces(64, ' ');
+		out_.put('\n');
+		for (size_t n = tabSize * level; n > 0; )
+		{
+			size_t chunk = n < spaces.size() ? n : spaces.size();
+			out_.write(spaces.data(), chunk);
+			n -= chunk;
+		}
+	}
+
+	//----< open element with tag and attributes >-----------------------
+
+	inline void XmlWriter::start(const std::string& tag, const Attributes& attribs)
+	{
+		indent(open_.size() + 1);
+		out_ << '<' << tag;
+		for (const auto& attrib : attribs)
+			out_ << ' ' << attrib.first << "=\"" << attrib.second << '\"';
+		out_ << '>';
+		open_.push_back(tag);
+	}
+
+	//----< close the most recently opened element >---------------------
+
+	inline void XmlWriter::end()
+	{
+		if (open_.empty())
+			throw(std::exception("no open element to end"));
+		indent(open_.size());
+		out_ << "</" << open_.back() << '>';
+		open_.pop_back();
+	}
+
+	//----< write text body of the open element >------------------------
+
+	inline void XmlWriter::text(const std::string& body)
+	{
+		indent(open_.size() + 1);
+		out_ << body;
+	}
+
+	//----< write element holding only text >----------------------------
+	/*
+	*  - an empty body writes no text line, as makeTaggedElement does
+	*/
+	inline void XmlWriter::element(const std::string& tag, const std::string& body)
+	{
+		start(tag);
+		if (body.size() > 0)
+			text(body);
+		end();
+	}
+
+	//----< write an XmlElement tree, e.g., one built by a payload >-----
+
+	inline void XmlWriter::element(SPtr pElem)
+	{
+		XmlProcessing::XmlOut xml(out_);
+		pElem->write(xml, open_.size() + 1);
+	}
+}
+
+#endif
@@ -24,11 +24,24 @@
 *   - testR6								: demonstrate first, second, third, and fourth part of requirement #6
 *   - testQuery								: demonstrate fifth part of requirement #6, and first and second part of requirement #7
 *   - testSpecializedSelectors				: demonstrate specialized selectors for common queries
+*   - testQueryBorrowsDb					: demonstrate that a Query views the live db without copying it
+*   - testIndexedSelectors					: demonstrate that indexed selectors agree with scanning selectors
+*   - testPatternFastPaths					: demonstrate that pattern fast paths agree with std::regex_match
+*   - testSnapshotQuery						: demonstrate a Query over a snapshot while a writer commits
+*   - testParallelSelect					: demonstrate that parallel selectors match single threaded ones
+*   - testPlanner							: demonstrate select(Conditions) ordering its predicates by selectivity
+*   - testCursor							: demonstrate pulling query results through a Cursor
+*   - testSetAlgebra						: demonstrate union, intersection, and difference of large results
+*   - testReadAllocations					: benchmark heap allocations made by a query's read path
+*
+* The test stub replaces every form of global operator new and delete
+* to count allocations, so testReadAllocations is built only with
+* TEST_QUERY.
 *
 * Required Files:
 * ---------------
 * Queries.h, Queries.cpp,
-* DbCore.h, DbCore.cpp
+* DbCore.h, DbCore.cpp, VersionedDbCore.h
 * StringUtilities.h, StringUtilities.cpp
 * TestUtilities.h, TestUtilities.cpp
 *
@@ -43,11 +56,18 @@
 
 #include "Queries.h"
 #include "../DbCore/DbCore.h"
+#include "../DbCore/VersionedDbCore.h"
 #include "../Payload/Payload.h"
 #include "../Utilities/StringUtilities/StringUtilities.h"
 #include "../Utilities/TestUtilities/TestUtilities.h"
 #include <iostream>
 #include <functional>
+#include <thread>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
 
 using namespace NoSqlDb;
 
@@ -257,8 +277,440 @@ bool testSpecializedSelectors() {
 	putLine(2);
 	return true;
 }
+//----< demonstrate that a Query views the live db without copying it >------
+
+bool testQueryBorrowsDb()
+{
+	Utilities::title("Demonstrating that a Query borrows its db instead of copying it");
+	DbCore<PayLoad> db;
+	DbProvider dbp;
+	db = dbp.db();
+	Query<PayLoad> q(db);  // O(1) - no keys are copied here
+	DbElement<PayLoad> elem;
+	elem.name("Late");
+	elem.descrip("added after the query was built");
+	db["LateArrival"] = elem;
+	std::cout << "\n\nQuery command: q.selectName(\"Late\").show();\n";
+	q.selectName("Late").show();
+	putLine(2);
+	return q.keys().size() == 1 && q.keys()[0] == "LateArrival";
+}
+
+//----< demonstrate that indexed selectors agree with scanning selectors >---
+
+bool testIndexedSelectors()
+{
+	Utilities::title("Demonstrating selectors answered from DbCore's secondary indexes");
+	DbCore<PayLoad> db;
+	DbProvider dbp;
+	db = dbp.db();
+	DbCore<PayLoad> indexedDb = db;
+	indexedDb.indexing(true);
+
+	auto sorted = [](Query<PayLoad>& q) {
+		Query<PayLoad>::Keys keys = q.keys();
+		std::sort(keys.begin(), keys.end());
+		return keys;
+	};
+	DateTime dt = DateTime().now();
+	DateTime::Duration dur = DateTime::makeDuration(1, 0, 0, 0);
+	Query<PayLoad> q1(db), i1(indexedDb);
+	q1.selectName("Nikhil");
+	i1.selectName("Nikhil");
+	Query<PayLoad> q2(db), i2(indexedDb);
+	q2.selectCategory("TA");
+	i2.selectCategory("TA");
+	Query<PayLoad> q3(db), i3(indexedDb);
+	q3.selectDesc(".*CSE.*");
+	i3.selectDesc(".*CSE.*");
+	Query<PayLoad> q4(db), i4(indexedDb);
+	q4.selectTimeInterval(dt - dur, dt + dur);
+	i4.selectTimeInterval(dt - dur, dt + dur);
+	if (sorted(q1) != sorted(i1) || sorted(q2) != sorted(i2) || sorted(q3) != sorted(i3) || sorted(q4) != sorted(i4))
+		return false;
+
+	// a query narrowed to fewer keys than the index returns tests just those keys
+	Query<PayLoad>::Keys few = { "Salman", "Nikhil", "no such key" };
+	Query<PayLoad> q6(db), i6(indexedDb);
+	q6.from(few).selectCategory("TA").selectTimeInterval(dt - dur, dt + dur);
+	i6.from(few).selectCategory("TA").selectTimeInterval(dt - dur, dt + dur);
+	std::cout << "\n  narrowed to " << few.size() << " keys: " << i6.keys().size() << " in category TA";
+	if (sorted(q6) != sorted(i6) || i6.keys().empty())
+		return false;
+
+	// ticks are whole seconds: records in the same second as either end are still found
+	DateTime second(DateTime::makeTime(2026, 10, 18, 12));
+	const char* keys[] = { "sameSecondEarly", "sameSecondStart", "sameSecondEnd" };
+	const size_t millisecs[] = { 50, 200, 800 };
+	for (size_t i = 0; i < 3; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.dateTime(second + DateTime::makeDuration(0, 0, 0, millisecs[i]));
+		db.put(keys[i], elem);
+		indexedDb.put(keys[i], elem);
+	}
+	DateTime after = second + DateTime::makeDuration(0, 0, 0, 100);
+	DateTime before = second + DateTime::makeDuration(0, 0, 0, 900);
+	Query<PayLoad> q7(db), i7(indexedDb);
+	q7.selectTimeInterval(after, before);
+	i7.selectTimeInterval(after, before);
+	std::cout << "\n  " << i7.keys().size() << " records found within one second";
+	if (sorted(q7) != sorted(i7) || sorted(i7) != Query<PayLoad>::Keys({ "sameSecondEnd", "sameSecondStart" }))
+		return false;
+
+	// edits made through operator[] are seen by the next indexed query
+	indexedDb["Salman"].name("Renamed");
+	Query<PayLoad> i5(indexedDb);
+	i5.selectName("Renamed");
+	putLine(2);
+	return i5.keys().size() == 1 && i5.keys()[0] == "Salman";
+}
+
+//----< demonstrate that pattern fast paths agree with std::regex_match >---
+
+bool testPatternFastPaths()
+{
+	Utilities::title("Demonstrating pattern fast paths and the pattern cache");
+	std::vector<std::string> patterns = { "Jim", "Ji.*", ".*im", ".*CSE.*", ".*", "", ".*a.*", "J[a-z]m", ".*CSE687" };
+	std::vector<std::string> texts = { "Jim", "Jimmy", "TA for CSE687", "Instructor for CSE687", "", "CSE", "two\nlines CSE", "aJim" };
+	for (const std::string& arg : patterns)
+	{
+		PatternCache::PatternPtr pattern = PatternCache::instance().get(arg);
+		std::regex regx(arg);
+		for (const std::string& text : texts)
+		{
+			if (pattern->matches(text) != std::regex_match(text, regx))
+			{
+				std::cout << "\n  pattern \"" << arg << "\" disagrees with std::regex on \"" << text << "\"";
+				return false;
+			}
+		}
+	}
+	size_t cached = PatternCache::instance().size();
+	PatternCache::instance().get(".*CSE.*");  // already compiled
+	std::cout << "\n  " << cached << " patterns cached, kind of \".*CSE.*\" = "
+		<< PatternCache::instance().get(".*CSE.*")->kind();
+	putLine();
+	return PatternCache::instance().size() == cached
+		&& PatternCache::instance().get("J[a-z]m")->kind() == Pattern::regex;
+}
+
+//----< demonstrate a Query over a snapshot while a writer commits >---
+
+bool testSnapshotQuery()
+{
+	Utilities::title("Demonstrating a Query over a VersionedDbCore snapshot");
+	DbProvider dbp;
+	VersionedDbCore<PayLoad> vdb;
+	for (const auto& item : dbp.db())
+		vdb.put(item.first, item.second);
+	Query<PayLoad> expected(dbp.db());
+	expected.selectCategory("TA");
+	Query<PayLoad>::Keys before = expected.keys();
+	std::sort(before.begin(), before.end());
+
+	DbSnapshot<PayLoad> snapshot = vdb.snapshot();  // O(1) - nothing is copied
+	std::thread writer([&vdb]()
+	{
+		for (size_t i = 0; i < 200; ++i)
+		{
+			DbElement<PayLoad> elem;
+			elem.name("Writer");
+			vdb.put("written" + std::to_string(i % 10), elem);
+		}
+		for (const std::string& key : vdb.snapshot().keys())
+			vdb.erase(key);
+	});
+	Query<PayLoad, DbSnapshot<PayLoad>> q(snapshot);
+	q.selectCategory("TA");
+	writer.join();
+	Query<PayLoad, DbSnapshot<PayLoad>>::Keys during = q.keys();
+	std::sort(during.begin(), during.end());
+	if (during != before || snapshot.size() != dbp.db().size() || vdb.snapshot().size() != 0)
+		return false;
+
+	size_t retained = vdb.versions();
+	snapshot = vdb.snapshot();  // closes the old snapshot
+	size_t freed = vdb.reclaim();
+	std::cout << "\n\n  " << retained << " versions retained while the snapshot was open, " << freed << " freed after";
+	putLine(2);
+	return freed == retained && vdb.versions() == 0;
+}
+
+//----< demonstrate that parallel selectors match single threaded ones >
+
+bool testParallelSelect()
+{
+	Utilities::title("Demonstrating selectors run on several threads");
+	DbCore<PayLoad> db;
+	for (size_t i = 0; i < 20000; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.name(i % 7 == 0 ? "Jim" + std::to_string(i) : "Fawcett" + std::to_string(i));
+		elem.descrip(i % 3 == 0 ? "TA for CSE687" : "student");
+		db["key" + std::to_string(i)] = elem;
+	}
+	auto run = [&db](size_t degree)
+	{
+		Query<PayLoad> q(db);
+		q.parallel(degree).select([](const DbElement<PayLoad>& elem) { return elem.descrip() != "student"; });
+		q.selectName("Jim[0-9]*");
+		return q.keys();
+	};
+	std::streambuf* saved = std::cout.rdbuf(nullptr);  // selectors print every match
+	Query<PayLoad>::Keys serial = run(1);
+	Query<PayLoad>::Keys parallel = run(4);
+	Query<PayLoad>::Keys all = run(0);
+	std::cout.rdbuf(saved);
+	std::cout << "\n  " << serial.size() << " matches on one thread, " << parallel.size()
+		<< " on four, " << all.size() << " on " << TaskPool::instance().workers() + 1;
+	putLine();
+	return serial.size() == 20000 / 21 + 1 && parallel == serial && all == serial;
+}
+
+//----< demonstrate select(Conditions) ordering its predicates >------
+
+bool testPlanner()
+{
+	Utilities::title("Demonstrating the planner behind select(Conditions)");
+	DbCore<PayLoad> db;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.name(i == 500 ? "Jim" : "student" + std::to_string(i));
+		elem.descrip(i % 2 == 0 ? "TA for CSE687" : "takes CSE687");
+		PayLoad pl;
+		pl.categories().push_back(i % 2 == 0 ? "TA" : "student");
+		elem.payLoad(pl);
+		db["key" + std::to_string(i)] = elem;
+	}
+	db.indexing(true);
+	Conditions<PayLoad> cond;
+	cond.descrip(".*CSE.*").category("TA").name("Jim");
+
+	std::vector<PlanStep> steps = Query<PayLoad>(db).plan(cond);
+	const char* kinds[] = { "name", "descrip", "category", "time" };
+	std::cout << "\n  plan:";
+	for (const PlanStep& step : steps)
+		std::cout << " " << kinds[step.kind] << (step.indexed ? " (indexed, ~" : " (scan, ~") << step.estimate << ")";
+	if (steps.size() != 3 || steps[0].kind != PlanStep::name || steps[2].kind != PlanStep::descrip)
+		return false;
+
+	Query<PayLoad> q(db);
+	q.select(cond);
+	std::ostringstream out;
+	std::streambuf* saved = std::cout.rdbuf(out.rdbuf());  // selectors print what they run
+	Query<PayLoad> none(db);
+	none.select(Conditions<PayLoad>().name("Nobody").descrip(".*CSE.*"));
+	std::cout.rdbuf(saved);
+	putLine();
+	bool skipped = out.str().find("contain a description") == std::string::npos;
+	return q.keys() == Query<PayLoad>::Keys({ "key500" }) && none.keys().empty() && skipped;
+}
+
+//----< demonstrate pulling query results through a Cursor >---------
+
+bool testCursor()
+{
+	Utilities::title("Demonstrating lazy query results with Cursor");
+	DbCore<PayLoad> db;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		DbElement<PayLoad> elem;
+		elem.name(i % 5 == 0 ? "Jim" + std::to_string(i) : "Fawcett" + std::to_string(i));
+		elem.descrip(i % 2 == 0 ? "TA for CSE687" : "student");
+		db["key" + std::to_string(i)] = elem;
+	}
+	Cursor<PayLoad>::Keys all = Cursor<PayLoad>(db).whereName("Jim.*").whereDesc(".*CSE.*").keys();
+	Cursor<PayLoad> page(db);
+	page.whereName("Jim.*").whereDesc(".*CSE.*").offset(3).limit(4);
+	std::cout << "\n  page of matches:";
+	while (page.next())
+		std::cout << " " << page.key() << " (" << page.elem().name() << ")";
+	Cursor<PayLoad>::Keys paged = Cursor<PayLoad>(db).whereName("Jim.*").whereDesc(".*CSE.*").offset(3).limit(4).keys();
+	if (all.size() != 100 || paged != Cursor<PayLoad>::Keys(all.begin() + 3, all.begin() + 7))
+		return false;
+
+	// a limit stops the scan: only two records are ever tested
+	size_t tested = 0;
+	Cursor<PayLoad> first(db);
+	first.where([&tested](const std::string&, const DbElement<PayLoad>&) { ++tested; return true; }).limit(2);
+	size_t pulled = first.forEach([](const std::string&, const DbElement<PayLoad>&) {});
+
+	// a cursor over a query's keys, and over a snapshot
+	std::streambuf* saved = std::cout.rdbuf(nullptr);
+	Query<PayLoad> q(db);
+	q.selectDesc(".*CSE.*");
+	std::cout.rdbuf(saved);
+	size_t fromQuery = q.cursor().whereName("Jim.*").forEach([](const std::string&, const DbElement<PayLoad>&) {});
+	VersionedDbCore<PayLoad> vdb;
+	vdb.put("only", db["key0"]);
+	DbSnapshot<PayLoad> snapshot = vdb.snapshot();
+	Cursor<PayLoad, DbSnapshot<PayLoad>>::Keys snapshotKeys = Cursor<PayLoad, DbSnapshot<PayLoad>>(snapshot).whereName("Jim0").keys();
+	std::cout << "\n  tested " << tested << " records for a limit of 2; " << fromQuery << " matches from the query's keys";
+	putLine();
+	return tested == 2 && pulled == 2 && fromQuery == 100 && snapshotKeys == Cursor<PayLoad>::Keys({ "only" });
+}
+
+//----< demonstrate union, intersection, and difference of results >--
+
+bool testSetAlgebra()
+{
+	Utilities::title("Demonstrating set algebra on query results");
+	DbCore<PayLoad> db;
+	Query<PayLoad>::Keys evens, threes;
+	for (size_t i = 100000; i > 0; --i)  // unsorted, as a scan would return them
+	{
+		if (i % 2 == 0)
+			evens.push_back("key" + std::to_string(i));
+		if (i % 3 == 0)
+			threes.push_back("key" + std::to_string(i));
+	}
+	std::streambuf* saved = std::cout.rdbuf(nullptr);  // each operator prints a banner
+	Query<PayLoad> both(db), either(db), onlyEven(db);
+	both.from(evens).keysIntersect(threes);
+	either.from(evens).keysUnion(threes);
+	onlyEven.from(evens).keysDifference(threes).keysUnion(both.keys());
+	std::cout.rdbuf(saved);
+
+	std::cout << "\n  " << evens.size() << " and " << threes.size() << " keys: " << both.keys().size()
+		<< " in both, " << either.keys().size() << " in either";
+	putLine();
+	const size_t sixes = 100000 / 6;
+	return both.keys().size() == sixes && either.keys().size() == evens.size() + threes.size() - sixes
+		&& std::equal(evens.begin(), evens.end(), either.keys().begin())  // current keys keep their order
+		&& onlyEven.keys().size() == evens.size();
+}
+
 #ifdef TEST_QUERY
 using namespace Utilities;
+
+//----< count every heap allocation made by the test stub >----------
+
+/*
+*  - every replaceable form is replaced, so no allocation escapes the
+*    count and sized or array deletes never reach the library's own
+*  - deletes release blocks through releaseBlock, which the optimizer
+*    cannot see through: a delete inlined to a plain free of a block
+*    from an operator new call it did not inline reads to g++ as a
+*    mismatched pair
+*/
+static std::atomic<size_t> allocations(0);
+static void (*volatile releaseBlock)(void*) = std::free;
+
+static void* countedAlloc(size_t size) noexcept
+{
+	++allocations;
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(size_t size)
+{
+	void* block = countedAlloc(size);
+	if (block == nullptr)
+		throw std::bad_alloc();
+	return block;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return countedAlloc(size);
+}
+
+void operator delete(void* block) noexcept
+{
+	releaseBlock(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+	releaseBlock(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+	releaseBlock(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+	releaseBlock(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+	releaseBlock(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+	releaseBlock(block);
+}
+
+//----< benchmark heap allocations made by a query's read path >-----
+
+bool testReadAllocations()
+{
+	Utilities::title("Benchmarking heap allocations made by a query's read path");
+	DbCore<PayLoad> db;
+	const size_t count = 10000;
+	for (size_t i = 0; i < count; ++i)
+	{
+		PayLoad payLoad("../Repository/Package" + std::to_string(i) + "/Package.h");
+		payLoad.categories().push_back("category" + std::to_string(i % 10));
+		db.emplace("record" + std::to_string(i), "a record name too long for a short string",
+			"a description too long for a short string", std::move(payLoad));
+		if (i > 0)
+			db.addChild("record" + std::to_string(i), "record" + std::to_string(i - 1));
+	}
+	const DbCore<PayLoad>& reader = db;
+
+	std::streambuf* saved = std::cout.rdbuf(nullptr);  // selectors print banners
+	Query<PayLoad> q(db);
+	const std::string category = "no such category";  // built before counting starts
+	size_t before = allocations;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	q.selectCategory(category);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	size_t queryAllocations = allocations - before;
+	std::cout.rdbuf(saved);
+
+	Cursor<PayLoad> matches(db);
+	matches.whereCategory("category3");  // filters are built before counting starts
+	before = allocations;
+	size_t found = matches.forEach([](const std::string&, const DbElement<PayLoad>&) {});
+	size_t cursorAllocations = allocations - before;
+
+	before = allocations;
+	size_t chars = 0;
+	for (const auto& item : reader)
+	{
+		const DbElement<PayLoad>& elem = item.second;
+		chars += elem.name().size() + elem.descrip().size() + elem.children().size();
+		chars += elem.payLoad().filePath().size();
+		for (const std::string& category : elem.payLoad().categories())
+			chars += category.size();
+	}
+	size_t readAllocations = allocations - before;
+
+	std::cout << "\n  selectCategory over " << count << " records: " << queryAllocations << " allocations, "
+		<< elapsed.count() << " ms";
+	std::cout << "\n  Cursor over the same records: " << found << " matches, " << cursorAllocations << " allocations";
+	std::cout << "\n  reading every field of every record: " << readAllocations << " allocations, " << chars << " chars";
+	putLine();
+	return queryAllocations == 0 && found == count / 10 && cursorAllocations == 0 && readAllocations == 0;
+}
+
 int main()
 {
 	Utilities::Title("Testing DbCore - He said, she said database");
@@ -271,11 +723,29 @@ int main()
 	TestExecutive::TestStr ts3{ testR6, "Testing queries" };
 	TestExecutive::TestStr ts4{ testQuery, "Testing Query mechanisms" };
 	TestExecutive::TestStr ts5{ testSpecializedSelectors, "Testing Query mechanisms" };
+	TestExecutive::TestStr ts6{ testQueryBorrowsDb, "Testing Query views the live db" };
+	TestExecutive::TestStr ts7{ testIndexedSelectors, "Testing indexed selectors" };
+	TestExecutive::TestStr ts8{ testPatternFastPaths, "Testing pattern fast paths" };
+	TestExecutive::TestStr ts9{ testSnapshotQuery, "Testing queries over a snapshot" };
+	TestExecutive::TestStr ts10{ testParallelSelect, "Testing parallel selectors" };
+	TestExecutive::TestStr ts11{ testPlanner, "Testing the select(Conditions) planner" };
+	TestExecutive::TestStr ts12{ testCursor, "Testing lazy Cursor results" };
+	TestExecutive::TestStr ts13{ testSetAlgebra, "Testing set algebra on query results" };
+	TestExecutive::TestStr ts14{ testReadAllocations, "Testing that reading records does not allocate" };
 	ex.registerTest(ts1);
 	ex.registerTest(ts2);
 	ex.registerTest(ts3);
 	ex.registerTest(ts4);
 	ex.registerTest(ts5);
+	ex.registerTest(ts6);
+	ex.registerTest(ts7);
+	ex.registerTest(ts8);
+	ex.registerTest(ts9);
+	ex.registerTest(ts10);
+	ex.registerTest(ts11);
+	ex.registerTest(ts12);
+	ex.registerTest(ts13);
+	ex.registerTest(ts14);
 
 	// run tests
 
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////////////////////
 // Queries.h - retrieve NoSqlDb contents										   //
-// ver 1.0                                                                         //
+// ver 1.11                                                                        //
 //                                                                                 //
 // Environment : C++ Console Application                                           //
 // Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
@@ -13,13 +13,39 @@
 /*
 * Package Operations:
 * -------------------
-* This package provides two classes:
+* This package provides these classes:
 * - Conditions instances hold a DbElement<P> to support compound queries.
 *
 * - Query instances hold a reference to a database and a vector of keys
 *   and returns a set of matching keys against different type of queries
 *  which includes compound queries like "AND OR".
-* - When constructed those keys are db.keys()
+* - When constructed those keys are db.keys(), but that key set is not
+*   materialized: the first selector scans the db in place, so building
+*   a Query costs O(1) regardless of database size.
+* - Pattern and PatternCache compile each regular-expression pattern
+*   once, and match literal, prefix, suffix, and ".*literal.*" patterns
+*   with plain string compares instead of std::regex.
+* - When the db has its secondary indexes turned on, selectors whose
+*   predicate can be answered from an index (exact name, category,
+*   time interval, ".*literal.*" description) start from the index's
+*   candidate keys instead of scanning - unless the query has already
+*   been narrowed to fewer keys than the index would return, when
+*   testing those keys is cheaper and the index is not read.
+* - select(Conditions) runs its conditions in the order a small planner
+*   picks, cheapest and most selective first, using DbIndex's counts
+*   when the db is indexed, and stops once no keys are left.
+* - keysUnion, keysIntersect, and keysDifference hash each key once to
+*   a RecordId local to the call, and merge sorted id vectors, so no
+*   strings are compared or sorted.  Results keep the current keys'
+*   order, with keys only the other side had following them.
+* - Cursor streams (key, record) pairs through filters as they are
+*   pulled, with offset and limit, so a pipeline never builds a key
+*   vector and a limited one stops scanning once it has enough.
+* - parallel(n) splits a selector's keys into chunks tested on a shared
+*   work-stealing TaskPool, merging matches in their original order.
+* - Query reads through a Db type parameter, DbCore<T> by default.  Any
+*   type with DbCore's const interface will do; Query<T, DbSnapshot<T>>
+*   queries a VersionedDbCore snapshot while writers keep committing.
 *
 *
 *
@@ -42,13 +68,21 @@ and when done replaces its original keys with the new key set
 *   - selectTimeInterval		:  demonstrate all keys that match time interval in metadata section, where the specification is based on a regular-expression pattern
 *   - selectDate				: demonstrate all keys that match time in metadata section, where the specification is based on a regular-expression pattern
 *   - keysUnion								: demonstrate the union of results of one or more previous queries, e.g., an "or"ing of multiple queries., where the specification is based on a regular-expression pattern
+*   - keysIntersect							: keeps current keys also in another result, an "and"ing of queries
+*   - keysDifference						: drops current keys that are in another result
 *   - selectCategory								: demonstrate all keys that match category in payload section, where the specification is based on a regular-expression pattern
 *   - selectFilePath								: all keys that match filepath in payload section, where the specification is based on a regular-expression pattern
+*   - parallel								: sets how many threads a selector may use
+*   - plan									: orders the predicates of a Conditions by estimated cost
+*   - cursor								: streams the current key set's records through a Cursor
+*   - Cursor::where, whereName, whereDesc, whereCategory	: adds a lazily applied filter
+*   - Cursor::offset, limit					: skips leading matches, stops after a count
+*   - Cursor::next, key, elem, forEach, keys	: pulls matches one at a time
 *
 
 * Required Files:
 * ---------------
-* Queries.h, Queries.cpp,
+* Queries.h, Queries.cpp, TaskPool.h
 * DbCore.h, DbCore.cpp
 * StringUtilities.h, StringUtilities.cpp
 * TestUtilities.h, TestUtilities.cpp
@@ -59,16 +93,220 @@ and when done replaces its original keys with the new key set
 *
 * Maintenance History:
 * --------------------
+* ver 1.11 : 18 Oct 2026
+* - set algebra merges RecordId vectors instead of sorting keys
+* ver 1.10 : 18 Oct 2026
+* - indexed selectors test the current keys directly when there are
+*   fewer of them than index candidates
+* ver 1.9 : 18 Oct 2026
+* - selectCategory reads categories without copying them
+* ver 1.8 : 18 Oct 2026
+* - keysUnion merges sorted keys instead of searching for each one;
+*   added keysIntersect and keysDifference
+* ver 1.7 : 18 Oct 2026
+* - added Cursor, pull-based results with lazy filters, offset, and limit
+* ver 1.6 : 18 Oct 2026
+* - select(Conditions) plans its predicates instead of running them as
+*   written; Conditions gained category and time interval
+* ver 1.5 : 18 Oct 2026
+* - selectors may test keys on several threads, set per query by parallel
+* ver 1.4 : 18 Oct 2026
+* - Query takes the type of db it reads as a parameter, so it can run
+*   against a DbSnapshot
+* ver 1.3 : 18 Oct 2026
+* - cached, pre-classified patterns with non-regex fast paths
+* ver 1.2 : 18 Oct 2026
+* - selectors use DbCore's secondary indexes when they are turned on
+* ver 1.1 : 18 Oct 2026
+* - Query borrows the db instead of copying it, and defers building
+*   its key set until a selector or keys() needs one
 * ver 1.0 : 5 Feb 2018
 */
 #include "../DbCore/DbCore.h"
+#include "TaskPool.h"
 #include <functional>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <regex>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <cstring>
+#include <iterator>
+#include <utility>
 namespace NoSqlDb
 {
+	/////////////////////////////////////////////////////////
+	// Pattern instances compile a regular-expression pattern
+	// once, and match it the cheapest way its shape allows:
+	// - "literal"      : string compare
+	// - "literal.*"    : prefix compare
+	// - ".*literal"    : suffix compare
+	// - ".*literal.*"  : substring search
+	// - anything else  : std::regex_match
+	// - ".*" does not match line terminators, so text holding
+	//   '\n' or '\r' always goes to std::regex_match, which is
+	//   compiled on first use for the fast-path shapes
+	//
+	class Pattern
+	{
+	public:
+		enum Kind { exact, prefix, suffix, contains, regex };
+
+		explicit Pattern(const std::string& pattern);
+		bool matches(const std::string& text) const;
+		Kind kind() const { return kind_; }
+		const std::string& literal() const { return literal_; }
+		static bool isLiteral(const std::string& pattern);
+		static bool find(const std::string& text, const std::string& literal);
+
+	private:
+		const std::regex& compiled() const;
+
+		Kind kind_ = regex;
+		std::string pattern_;
+		std::string literal_;
+		mutable std::regex regex_;
+		mutable std::once_flag compileOnce_;
+	};
+
+	//----< does pattern match nothing but itself as a regex? >----------
+
+	inline bool Pattern::isLiteral(const std::string& pattern)
+	{
+		return pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+	}
+
+	//----< classify pattern, compiling a regex only if needed >---------
+
+	inline Pattern::Pattern(const std::string& pattern) : pattern_(pattern)
+	{
+		const std::string any = ".*";
+		bool lead = pattern.compare(0, any.size(), any) == 0;
+		bool trail = pattern.size() >= any.size() + (lead ? any.size() : 0)
+			&& pattern.compare(pattern.size() - any.size(), any.size(), any) == 0;
+		size_t first = lead ? any.size() : 0;
+		size_t last = trail ? pattern.size() - any.size() : pattern.size();
+		std::string inner = pattern.substr(first, last - first);
+		if (isLiteral(inner))
+		{
+			literal_ = inner;
+			kind_ = lead ? (trail ? contains : suffix) : (trail ? prefix : exact);
+		}
+		else
+			compiled();  // compile now, so a bad pattern throws std::regex_error here
+	}
+
+	//----< regex for pattern, compiled once even if shared by threads >-
+
+	inline const std::regex& Pattern::compiled() const
+	{
+		std::call_once(compileOnce_, [this]() { regex_ = std::regex(pattern_); });
+		return regex_;
+	}
+
+	//----< substring search: memchr for the first byte, then memcmp >---
+
+	inline bool Pattern::find(const std::string& text, const std::string& literal)
+	{
+		if (literal.empty())
+			return true;
+		if (literal.size() > text.size())
+			return false;
+		const char* pos = text.data();
+		const char* stop = text.data() + text.size() - literal.size() + 1;
+		while (pos < stop)
+		{
+			pos = static_cast<const char*>(std::memchr(pos, literal[0], stop - pos));
+			if (pos == nullptr)
+				return false;
+			if (std::memcmp(pos, literal.data(), literal.size()) == 0)
+				return true;
+			++pos;
+		}
+		return false;
+	}
+
+	//----< does text match the whole pattern? >-------------------------
+
+	inline bool Pattern::matches(const std::string& text) const
+	{
+		if (kind_ == exact)
+			return text == literal_;
+		if (kind_ == regex || text.find_first_of("\r\n") != std::string::npos)
+			return std::regex_match(text, compiled());
+		size_t size = literal_.size();
+		switch (kind_)
+		{
+		case prefix:
+			return text.size() >= size && std::memcmp(text.data(), literal_.data(), size) == 0;
+		case suffix:
+			return text.size() >= size && std::memcmp(text.data() + text.size() - size, literal_.data(), size) == 0;
+		default:
+			return find(text, literal_);
+		}
+	}
+
+	/////////////////////////////////////////////////////////
+	// PatternCache holds compiled Patterns keyed by pattern
+	// string, so repeated queries do not recompile them.
+	// - shared by all Query instances and safe to use from
+	//   several threads
+	// - emptied when it reaches maxSize entries
+	//
+	class PatternCache
+	{
+	public:
+		using PatternPtr = std::shared_ptr<const Pattern>;
+
+		static PatternCache& instance() { static PatternCache cache; return cache; }
+		PatternPtr get(const std::string& pattern);
+		size_t size();
+		void clear();
+
+	private:
+		static const size_t maxSize = 256;
+		std::mutex mtx_;
+		std::unordered_map<std::string, PatternPtr> patterns_;
+	};
+
+	//----< returns compiled pattern, compiling it on first use >--------
+
+	inline PatternCache::PatternPtr PatternCache::get(const std::string& pattern)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx_);
+			auto iter = patterns_.find(pattern);
+			if (iter != patterns_.end())
+				return iter->second;
+		}
+		PatternPtr compiled = std::make_shared<const Pattern>(pattern);  // may throw std::regex_error
+		std::lock_guard<std::mutex> lock(mtx_);
+		if (patterns_.size() >= maxSize)
+			patterns_.clear();
+		patterns_[pattern] = compiled;
+		return compiled;
+	}
+
+	//----< number of cached patterns >----------------------------------
+
+	inline size_t PatternCache::size()
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		return patterns_.size();
+	}
+
+	//----< discard all cached patterns >--------------------------------
+
+	inline void PatternCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		patterns_.clear();
+	}
+
 	/////////////////////////////////////////////////////////
 	// Conditions instances hold a DbElement<P>
 	// to support compound queries.
@@ -95,14 +333,248 @@ namespace NoSqlDb
 		std::string payLoad() const { return payLoad_; }
 		Conditions<T>& payLoad(const T& payLoad) { payLoad_ = payLoad; return *this; }
 
+		std::string& category() { return category_; }
+		std::string category() const { return category_; }
+		Conditions<T>& category(const std::string& category) { category_ = category; return *this; }
+
+		// records with after < dateTime < before
+		bool hasTimeInterval() const { return hasInterval_; }
+		DateTime after() const { return after_; }
+		DateTime before() const { return before_; }
+		Conditions<T>& timeInterval(const DateTime& after, const DateTime& before)
+		{
+			after_ = after;
+			before_ = before;
+			hasInterval_ = true;
+			return *this;
+		}
+
 	private:
 		std::string name_;
 		std::string descrip_;
 		DateTime dateTime_;
 		T payLoad_;
 		DbElement<T> el_;
+		std::string category_;
+		DateTime after_;
+		DateTime before_;
+		bool hasInterval_ = false;
+	};
+
+	/////////////////////////////////////////////////////////
+	// PlanStep is one predicate of a planned select(Conditions):
+	// - estimate is the number of records expected to satisfy it,
+	//   from DbIndex counts when the db is indexed, else from a
+	//   fixed selectivity for the predicate's shape
+	// - cost is the work of testing one record, in string compares;
+	//   an indexed step touches only its candidates, so its cost per
+	//   record is its selectivity
+	// - rank orders the steps: cost / (1 - selectivity), the classic
+	//   ordering for a chain of independent filters
+	//
+	struct PlanStep
+	{
+		enum Kind { name, descrip, category, time };
+
+		Kind kind;
+		bool indexed;
+		double estimate;
+		double cost;
+		double rank;
+	};
+
+
+	///////////////////////////////////////////////////////////////////
+	// Cursor streams the records of a db that pass its filters, one at
+	// a time, as the consumer pulls them:
+	// - a cursor reads either every record of the db or a list of keys,
+	//   e.g. a Query's current key set, which it borrows, not copies
+	// - where() adds a filter; filters run only on records the cursor
+	//   reaches, in the order they were added
+	// - offset(n) skips the first n matches, limit(n) stops after n, so
+	//   the rest of the scan is never done
+	// - key() and elem() refer into the db and are valid until it changes;
+	//   the db, and any borrowed keys, must outlive the cursor
+	//
+	template <typename T, typename Db = DbCore<T>>
+	class Cursor
+	{
+	public:
+		using Key = std::string;
+		using Keys = std::vector<std::string>;
+		using Pred = std::function<bool(const Key&, const DbElement<T>&)>;
+
+		Cursor(const Db& db) : db_(db) {}
+		Cursor(const Db& db, const Keys& keys) : db_(db), keys_(&keys) {}
+		Cursor& where(Pred pred);
+		Cursor& whereName(const std::string& pattern);
+		Cursor& whereDesc(const std::string& pattern);
+		Cursor& whereCategory(const std::string& category);
+		Cursor& offset(size_t count) { offset_ = count; return *this; }
+		Cursor& limit(size_t count) { limit_ = count; return *this; }
+		bool next();
+		const Key& key() const { return *key_; }
+		const DbElement<T>& elem() const { return *elem_; }
+		template<typename F>
+		size_t forEach(F f);
+		Keys keys();
+
+	private:
+		using Iterator = decltype(std::declval<const Db&>().begin());
+		bool advance();
+		bool passes() const;
+
+		const Db& db_;
+		const Keys* keys_ = nullptr;  // null when reading every record
+		std::vector<Pred> filters_;
+		Iterator iter_;
+		size_t pos_ = 0;
+		bool started_ = false;
+		size_t offset_ = 0;
+		size_t limit_ = static_cast<size_t>(-1);
+		size_t skipped_ = 0;
+		size_t returned_ = 0;
+		const Key* key_ = nullptr;
+		const DbElement<T>* elem_ = nullptr;
 	};
 
+	//----< add a filter, run after those already added >---------------
+
+	template<typename T, typename Db>
+	Cursor<T, Db>& Cursor<T, Db>::where(Pred pred)
+	{
+		filters_.push_back(pred);
+		return *this;
+	}
+
+	//----< keep records whose name matches pattern >-------------------
+
+	template<typename T, typename Db>
+	Cursor<T, Db>& Cursor<T, Db>::whereName(const std::string& pattern)
+	{
+		PatternCache::PatternPtr compiled = PatternCache::instance().get(pattern);
+		return where([compiled](const Key&, const DbElement<T>& elem) { return compiled->matches(elem.name()); });
+	}
+
+	//----< keep records whose description matches pattern >------------
+
+	template<typename T, typename Db>
+	Cursor<T, Db>& Cursor<T, Db>::whereDesc(const std::string& pattern)
+	{
+		PatternCache::PatternPtr compiled = PatternCache::instance().get(pattern);
+		return where([compiled](const Key&, const DbElement<T>& elem) { return compiled->matches(elem.descrip()); });
+	}
+
+	//----< keep records whose payload has category >-------------------
+
+	template<typename T, typename Db>
+	Cursor<T, Db>& Cursor<T, Db>::whereCategory(const std::string& category)
+	{
+		return where([category](const Key&, const DbElement<T>& elem) {
+			const typename T::Categories& categories = elem.payLoad().categories();
+			return std::find(categories.begin(), categories.end(), category) != categories.end();
+		});
+	}
+
+	//----< step to the next record of the source, false at its end >---
+
+	template<typename T, typename Db>
+	bool Cursor<T, Db>::advance()
+	{
+		if (keys_ != nullptr)
+		{
+			for (; pos_ < keys_->size(); ++pos_)
+			{
+				const Key& key = (*keys_)[pos_];
+				if (db_.contains(key))
+				{
+					key_ = &key;
+					elem_ = &db_[key];
+					++pos_;
+					return true;
+				}
+			}
+			return false;
+		}
+		if (!started_)
+		{
+			iter_ = db_.begin();
+			started_ = true;
+		}
+		else
+			++iter_;
+		if (iter_ == db_.end())
+			return false;
+		const auto& item = *iter_;
+		key_ = &item.first;
+		elem_ = &item.second;
+		return true;
+	}
+
+	//----< does the current record pass every filter? >----------------
+
+	template<typename T, typename Db>
+	bool Cursor<T, Db>::passes() const
+	{
+		for (const Pred& pred : filters_)
+		{
+			if (!pred(*key_, *elem_))
+				return false;
+		}
+		return true;
+	}
+
+	//----< move to the next match, false when there are no more >------
+	/*
+	*  - once limit matches have been returned the source is not read
+	*    again
+	*/
+	template<typename T, typename Db>
+	bool Cursor<T, Db>::next()
+	{
+		if (returned_ >= limit_)
+			return false;
+		while (advance())
+		{
+			if (!passes())
+				continue;
+			if (skipped_ < offset_)
+			{
+				++skipped_;
+				continue;
+			}
+			++returned_;
+			return true;
+		}
+		limit_ = returned_;  // source exhausted; stay at the end
+		return false;
+	}
+
+	//----< call f(key, elem) for each remaining match, returning count >
+
+	template<typename T, typename Db>
+	template<typename F>
+	size_t Cursor<T, Db>::forEach(F f)
+	{
+		size_t count = 0;
+		while (next())
+		{
+			f(key(), elem());
+			++count;
+		}
+		return count;
+	}
+
+	//----< collect the remaining matching keys >-----------------------
+
+	template<typename T, typename Db>
+	typename Cursor<T, Db>::Keys Cursor<T, Db>::keys()
+	{
+		Keys keys;
+		while (next())
+			keys.push_back(key());
+		return keys;
+	}
 
 	///////////////////////////////////////////////////////////////////
 	// Query class defines a single type of "query" function.
@@ -110,9 +582,16 @@ namespace NoSqlDb
 	//   and returns a set of matching keys against different type of queries 
 	//  which includes compound queries like "AND OR".
 	//
-	// - When constructed those keys are db.keys()
+	// - When constructed those keys are db.keys(), held implicitly until
+	//   a selector narrows them or keys() asks for them.
+	// - The db must outlive the Query.
+	// - Db is DbCore<T>, or any type with its const interface: keys,
+	//   contains, operator[], begin/end, indexing, and index.
+	// - parallel(n) lets selectors test up to n records at once; their
+	//   predicates, and CallObjs passed to select, must then be safe to
+	//   call from several threads.
 
-	template <typename T>
+	template <typename T, typename Db = DbCore<T>>
 	class Query
 	{
 	public:
@@ -120,40 +599,233 @@ namespace NoSqlDb
 		using Key = std::string;
 		using Keys = std::vector<std::string>;
 
-		Query(const DbCore<T>& db) { db_ = db; keys_ = db_.keys(); }
-		Query<T>& select(const Conditions<T>& cond);
+		Query(const Db& db) : db_(db) {}
+		Query& select(const Conditions<T>& cond);
+		std::vector<PlanStep> plan(const Conditions<T>& cond) const;
 		template<typename CallObj>
 		Query& select(CallObj callObj);
-		Query<T>& from(Keys& keys);
+		Query& from(const Keys& keys);
 		void show();
 		Keys& keys();
-		Query<T>& showSpecifiedKey(const Key& key);
-		Query<T>& showChildrenOfSpecifiedKey(const Key& key);
-		Query<T>& showMatchKey(const std::string& arg);
-		Query<T>& selectName(const std::string &arg);
-		Query<T>& selectDesc(const std::string &arg);
-		Query<T>& selectTimeInterval(DateTime dt1, DateTime dt2);
-		Query<T>& selectDate(DateTime dt1);
-		Query<T>& keysUnion(const Keys& keys);
-		Query<T>& selectCategory(const std::string& arg);
-		Query<T>& selectFilePath(const std::string& arg);
+		Query& showSpecifiedKey(const Key& key);
+		Query& showChildrenOfSpecifiedKey(const Key& key);
+		Query& showMatchKey(const std::string& arg);
+		Query& selectName(const std::string &arg);
+		Query& selectDesc(const std::string &arg);
+		Query& selectTimeInterval(DateTime dt1, DateTime dt2);
+		Query& selectDate(DateTime dt1);
+		Query& keysUnion(const Keys& keys);
+		Query& keysIntersect(const Keys& keys);
+		Query& keysDifference(const Keys& keys);
+		Query& selectCategory(const std::string& arg);
+		Query& selectFilePath(const std::string& arg);
+		Query& parallel(size_t degree);
+		Cursor<T, Db> cursor() const;
+		size_t parallel() const { return degree_; }
+
+		static const size_t parallelGrain = 1024;  // fewest keys one thread tests
 
 	private:
-		DbCore<T> db_;
+		template<typename Pred>
+		void filter(Pred pred);
+		template<typename Pred>
+		void filter(const Keys& candidates, Pred pred);
+		template<typename Count, typename Fetch, typename Pred>
+		void filterIndexed(Count count, Fetch fetch, Pred pred);
+		template<typename Test>
+		Keys collect(size_t count, Test test);
+		template<typename Merge>
+		void combine(const Keys& keys, Merge merge);
+
+		using Ids = std::vector<RecordId>;
+		struct KeyHash
+		{
+			size_t operator()(const Key* key) const { return std::hash<Key>()(*key); }
+		};
+		struct KeyEqual
+		{
+			bool operator()(const Key* a, const Key* b) const { return *a == *b; }
+		};
+		using IdMap = std::unordered_map<const Key*, RecordId, KeyHash, KeyEqual>;
+		static Ids toIds(const Keys& keys, IdMap& ids, std::vector<const Key*>& byId);
+
+		const Db& db_;
 		Keys keys_;
+		bool allKeys_ = true;  // true until keys_ has been materialized or narrowed
+		size_t degree_ = 1;
 	};
 
 	//----< returns current key set for db >-----------------------------
 
-	template<typename T>
-	typename Query<T>::Keys& Query<T>::keys()
+	template<typename T, typename Db>
+	typename Query<T, Db>::Keys& Query<T, Db>::keys()
 	{
+		if (allKeys_)
+		{
+			keys_ = db_.keys();
+			allKeys_ = false;
+		}
 		return keys_;
 	}
+
+	//----< keep only the current keys whose records satisfy pred >------
+	/*
+	*  - pred is called with a key and a const reference to its record
+	*  - before any narrowing the db is scanned in place, so the full key
+	*    set is never copied; a parallel scan copies only pointers to
+	*    the records, so they can be split among threads
+	*/
+	template<typename T, typename Db>
+	template<typename Pred>
+	void Query<T, Db>::filter(Pred pred)
+	{
+		Keys newKeys;
+		if (allKeys_ && degree_ <= 1)
+		{
+			for (const auto& item : db_)
+			{
+				if (pred(item.first, item.second))
+					newKeys.push_back(item.first);
+			}
+		}
+		else if (allKeys_)
+		{
+			std::vector<std::pair<const Key*, const DbElement<T>*>> items;
+			for (const auto& item : db_)
+				items.push_back(std::make_pair(&item.first, &item.second));
+			newKeys = collect(items.size(), [&items, &pred](size_t i, Keys& out)
+			{
+				if (pred(*items[i].first, *items[i].second))
+					out.push_back(*items[i].first);
+			});
+		}
+		else
+		{
+			newKeys = collect(keys_.size(), [this, &pred](size_t i, Keys& out)
+			{
+				const Key& key = keys_[i];
+				if (db_.contains(key) && pred(key, db_[key]))
+					out.push_back(key);
+			});
+		}
+		keys_.swap(newKeys);
+		allKeys_ = false;
+	}
+
+	//----< keep only current keys that are candidates and satisfy pred >
+	/*
+	*  - candidates come from a secondary index; pred is still checked so
+	*    the index only has to be a superset of the answer
+	*/
+	template<typename T, typename Db>
+	template<typename Pred>
+	void Query<T, Db>::filter(const Keys& candidates, Pred pred)
+	{
+		Keys newKeys;
+		if (allKeys_)
+		{
+			newKeys = collect(candidates.size(), [this, &candidates, &pred](size_t i, Keys& out)
+			{
+				const Key& key = candidates[i];
+				if (db_.contains(key) && pred(key, db_[key]))
+					out.push_back(key);
+			});
+		}
+		else
+		{
+			std::unordered_set<Key> candidateSet(candidates.begin(), candidates.end());
+			newKeys = collect(keys_.size(), [this, &candidateSet, &pred](size_t i, Keys& out)
+			{
+				const Key& key = keys_[i];
+				if (candidateSet.count(key) > 0 && db_.contains(key) && pred(key, db_[key]))
+					out.push_back(key);
+			});
+		}
+		keys_.swap(newKeys);
+		allKeys_ = false;
+	}
+
+	//----< narrow through an index, unless the current keys are fewer >
+	/*
+	*  - count(limit) is the number of index candidates, or at least
+	*    limit if there are that many; fetch() returns the candidates
+	*  - a query narrowed to k keys, with at least k candidates, tests
+	*    its k keys in O(k), instead of fetching every candidate
+	*/
+	template<typename T, typename Db>
+	template<typename Count, typename Fetch, typename Pred>
+	void Query<T, Db>::filterIndexed(Count count, Fetch fetch, Pred pred)
+	{
+		if (!allKeys_ && count(keys_.size()) >= keys_.size())
+			filter(pred);
+		else
+			filter(fetch(), pred);
+	}
+
+	//----< keys that test(i, out) appends for i in [0, count), in order of i >
+	/*
+	*  - with parallel(n), n > 1, and enough keys, [0, count) is split into
+	*    chunks of at least parallelGrain keys, tested on TaskPool, and the
+	*    chunks' keys are concatenated in chunk order, so the result is
+	*    the same as testing on one thread
+	*/
+	template<typename T, typename Db>
+	template<typename Test>
+	typename Query<T, Db>::Keys Query<T, Db>::collect(size_t count, Test test)
+	{
+		Keys matches;
+		if (degree_ <= 1 || count < 2 * parallelGrain)
+		{
+			for (size_t i = 0; i < count; ++i)
+				test(i, matches);
+			return matches;
+		}
+		size_t chunks = std::min(4 * degree_, count / parallelGrain);
+		std::vector<Keys> parts(chunks);
+		TaskPool::instance().parallelFor(count, degree_, chunks, [&parts, &test](size_t chunk, size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				test(i, parts[chunk]);
+		});
+		size_t total = 0;
+		for (const Keys& part : parts)
+			total += part.size();
+		matches.reserve(total);
+		for (Keys& part : parts)
+			std::move(part.begin(), part.end(), std::back_inserter(matches));
+		return matches;
+	}
+
+	//----< test up to degree records at once; 0 uses every pool thread >
+	/*
+	*  - the default, 1, runs every selector on the calling thread
+	*/
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::parallel(size_t degree)
+	{
+		degree_ = degree == 0 ? TaskPool::instance().workers() + 1 : degree;
+		return *this;
+	}
+
+	//----< cursor over the current key set, reading nothing until pulled >
+	/*
+	*  - before any selector has narrowed the keys the cursor reads every
+	*    record of the db; afterwards it borrows this query's keys, so the
+	*    query must outlive it and not be narrowed while it is in use
+	*/
+	template<typename T, typename Db>
+	Cursor<T, Db> Query<T, Db>::cursor() const
+	{
+		if (allKeys_)
+			return Cursor<T, Db>(db_);
+		return Cursor<T, Db>(db_, keys_);
+	}
+
 	//----< Display all matching keys >-----------------------------------
-	template<typename T>
-	void Query<T>::show()
+	template<typename T, typename Db>
+	void Query<T, Db>::show()
 	{
+		keys();
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n\nDisplay all matching keys";
@@ -171,60 +843,142 @@ namespace NoSqlDb
 
 	/*select uses conds1 DbElement parts to match db elements for each q1 key
 	and when done replaces its original keys with the new key set */
-
-	template <typename T>
-	Query<T>& Query<T>::select(const Conditions<T>& cond)
-	{
-		std::string name = cond.name();
-		std::string desc = cond.descrip();
-		if (!name.empty())
-			selectName(name);
-		if (!desc.empty())
-			selectDesc(desc);
+	/*
+	*  - the conditions run in the order plan gives, cheapest and most
+	*    selective first, and stop as soon as no keys are left
+	*/
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::select(const Conditions<T>& cond)
+	{
+		for (const PlanStep& step : plan(cond))
+		{
+			if (!allKeys_ && keys_.empty())
+				break;
+			switch (step.kind)
+			{
+			case PlanStep::name:
+				selectName(cond.name());
+				break;
+			case PlanStep::descrip:
+				selectDesc(cond.descrip());
+				break;
+			case PlanStep::category:
+				selectCategory(cond.category());
+				break;
+			case PlanStep::time:
+				selectTimeInterval(cond.after(), cond.before());
+				break;
+			}
+		}
 		return *this;
 	}
 
+	//----< order cond's predicates by estimated cost and selectivity >--
+	/*
+	*  - selectivities for unindexed steps are fixed guesses by pattern
+	*    shape; with indexing on they come from DbIndex counts
+	*  - a time range is counted only up to a tenth of the db, so the
+	*    estimate itself stays cheap; wider ranges are taken as a third
+	*/
+	template<typename T, typename Db>
+	std::vector<PlanStep> Query<T, Db>::plan(const Conditions<T>& cond) const
+	{
+		const bool indexed = db_.indexing();
+		const double records = indexed ? static_cast<double>(std::max<size_t>(db_.index().size(), 1)) : 1.0;
+		std::vector<PlanStep> steps;
+		auto add = [&steps, indexed, records](PlanStep::Kind kind, bool useIndex, double selectivity, double cost, size_t count)
+		{
+			PlanStep step;
+			step.kind = kind;
+			step.indexed = indexed && useIndex;
+			if (step.indexed)
+			{
+				selectivity = count / records;
+				cost = selectivity;
+			}
+			step.estimate = selectivity * records;
+			step.cost = cost;
+			step.rank = cost / (1.0 - std::min(selectivity, 0.99));
+			steps.push_back(step);
+		};
+		auto byShape = [](const Pattern& pattern, double& cost)
+		{
+			switch (pattern.kind())
+			{
+			case Pattern::exact: cost = 1; return 0.05;
+			case Pattern::prefix: case Pattern::suffix: cost = 1; return 0.1;
+			case Pattern::contains: cost = 2; return 0.2;
+			default: cost = 20; return 0.25;
+			}
+		};
+		if (!cond.name().empty())
+		{
+			PatternCache::PatternPtr pattern = PatternCache::instance().get(cond.name());
+			double cost;
+			double selectivity = byShape(*pattern, cost);
+			bool useIndex = pattern->kind() == Pattern::exact;
+			add(PlanStep::name, useIndex, selectivity, cost, indexed && useIndex ? db_.index().countName(pattern->literal()) : 0);
+		}
+		if (!cond.descrip().empty())
+		{
+			PatternCache::PatternPtr pattern = PatternCache::instance().get(cond.descrip());
+			double cost;
+			double selectivity = byShape(*pattern, cost);
+			bool useIndex = pattern->kind() != Pattern::regex && DbIndex<T>::canSearchDescrip(pattern->literal());
+			add(PlanStep::descrip, useIndex, selectivity, cost, indexed && useIndex ? db_.index().countDescrip(pattern->literal()) : 0);
+		}
+		if (!cond.category().empty())
+			add(PlanStep::category, true, 0.1, 4, indexed ? db_.index().countCategory(cond.category()) : 0);
+		if (cond.hasTimeInterval())
+		{
+			size_t count = 0;
+			if (indexed)
+			{
+				size_t limit = std::max<size_t>(static_cast<size_t>(records) / 10, 64);
+				count = db_.index().countTime(cond.after().ticks(), cond.before().ticks(), limit);
+				if (count == limit)
+					count = std::max(limit, static_cast<size_t>(records / 3));
+			}
+			add(PlanStep::time, true, 0.33, 1, count);
+		}
+		std::stable_sort(steps.begin(), steps.end(), [](const PlanStep& a, const PlanStep& b) { return a.rank < b.rank; });
+		return steps;
+	}
+
 	/*----< supports application defined queries for payload >---------*/
 	/*
 	*  - CallObj is defined by the application to return results from
 	*    application's payload.  See test stub for example uses.
 	*/
-	template<typename P>
+	template<typename P, typename Db>
 	template<typename CallObj>
-	Query<P>& Query<P>::select(CallObj callObj)
+	Query<P, Db>& Query<P, Db>::select(CallObj callObj)
 	{
-		Keys newKeys;
-		for (auto item : db_)
-		{
-			if (callObj(item.second))
-				newKeys.push_back(item.first);
-		}
-		keys_ = newKeys;
+		filter([&callObj](const Key&, const DbElement<P>& elem) { return callObj(elem); });
 		return *this;
 	}
 
 	//----<Get all keys from the resulting query  >-----------------------------------
-	template <typename T>
-	Query<T>& Query<T>::from(Keys& keys)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::from(const Keys& keys)
 	{
-		keys_.clear();
 		keys_ = keys;
+		allKeys_ = false;
 		return *this;
 	}
 
 	//---- <Demonstrate the value of a specified key >-----------------------------------
 
-	template <typename T>
-	Query<T>& Query<T>::showSpecifiedKey(const Key& key)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::showSpecifiedKey(const Key& key)
 	{
 		std::cout << "\n Demonstrating the value of a specified key";
-		DbCore<T>::DbStore dbStore_ = db_.dbStore();
 		if (db_.contains(key))
 		{
 			std::cout << "\n\n    Found key \"" << key << "\"";
 			std::cout << "\n------------------------------------------------------------------------------------";
 			std::cout << "\n\n    The value of key: ";
-			showElem(dbStore_[key]);
+			showElem(db_[key]);
 			std::cout << "\" \n";
 		}
 		else
@@ -234,17 +988,16 @@ namespace NoSqlDb
 
 	//---- < Demonstrate the children of a specified key >-----------------------------------
 
-	template <typename T>
-	Query<T>& Query<T>::showChildrenOfSpecifiedKey(const Key& key)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::showChildrenOfSpecifiedKey(const Key& key)
 	{
 		std::cout << "\n Demonstrating the children of a specified key";
-		DbCore<T>::DbStore dbStore_ = db_.dbStore();
 		if (db_.contains(key))
 		{
 			std::cout << "\n\n    Found key: \"" << key << "\"";
 			std::cout << "\n------------------------------------------------------------------------------------";
 			std::cout << "\n\n    The children of specified key: \"" << key << "\"";
-			typename DbElement<T>::Children children = dbStore_[key].children();
+			const typename DbElement<T>::Children& children = db_[key].children();
 			std::cout << "\n------------------------------------------------------------------------------------";
 			if (children.size() > 0)
 			{
@@ -264,20 +1017,18 @@ namespace NoSqlDb
 
 	//---- < Demonstrate the set of all keys matching a specified regular-expression pattern >-----------------------------------
 
-	template <typename T>
-	Query<T>& Query<T>::showMatchKey(const std::string &arg)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::showMatchKey(const std::string &arg)
 	{
 		std::cout << "\n Demonstrating the set of all keys matching a specified regular-expression pattern";
-		// get key
-		DbCore<std::string>::Keys dbCorekeys = db_.keys();
-		Query<std::string>::Keys queryKeys;
-		std::regex regx(arg);
-		// iterate though those keys 
+		Keys queryKeys;
+		PatternCache::PatternPtr pattern = PatternCache::instance().get(arg);
+		// iterate though db keys in place
 		std::cout << "\n\n Searching all keys with a specified regular-expression pattern \"" << arg << "\"";
-		for (auto key : dbCorekeys)
+		for (const auto& item : db_)
 		{
-			if (std::regex_match(key, regx))
-				queryKeys.push_back(key);
+			if (pattern->matches(item.first))
+				queryKeys.push_back(item.first);
 		}
 		if (queryKeys.size() > 0)
 		{
@@ -294,22 +1045,21 @@ namespace NoSqlDb
 
 	//---- < Demonstrate all keys that contain a name in metadata section, where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template <typename T>
-	Query<T>& Query<T>::selectName(const std::string &arg)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectName(const std::string &arg)
 	{
 		std::cout << "\n\n Demonstrating all keys that contain a name in metadata section, where the specification is based on a regular-expression pattern";
-		// get key
-		DbCore<PayLoad>::Keys queryKeys = keys_;
-		DbCore<PayLoad>::DbStore& dbs = db_.dbStore();
-		keys_.clear();
-		std::regex regx(arg);
-		// iterate though those keys 
 		std::cout << "\n\n Searching all keys with a name specified in a regular-expression pattern \"" << arg << "\"";
-		for (auto key : queryKeys)
+		PatternCache::PatternPtr pattern = PatternCache::instance().get(arg);
+		auto matches = [&pattern](const Key&, const DbElement<T>& elem) { return pattern->matches(elem.name()); };
+		if (db_.indexing() && pattern->kind() == Pattern::exact)
 		{
-			if (std::regex_match(dbs[key].name(), regx))
-				keys_.push_back(key);
+			const DbIndex<T>& index = db_.index();
+			const std::string& name = pattern->literal();
+			filterIndexed([&](size_t) { return index.countName(name); }, [&]() { return index.byName(name); }, matches);
 		}
+		else
+			filter(matches);  // iterate though current keys
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n    The matched keys: ";
@@ -322,7 +1072,7 @@ namespace NoSqlDb
 			std::cout << "\n    The matched names: ";
 			for (auto key : keys_)
 			{
-				std::cout << " " << dbs[key].name();
+				std::cout << " " << db_[key].name();
 			}
 
 		}
@@ -333,23 +1083,22 @@ namespace NoSqlDb
 
 	//---- < Demonstrate all keys that contain a description in metadata section, where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template<typename T>
-	Query<T>& Query<T>::selectDesc(const std::string &arg)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectDesc(const std::string &arg)
 	{
 		std::cout << "\n\n  Demonstrating all keys that contain a description in metadata section, where the specification is based on a regular-expression pattern";
-		// get key
-		DbCore<PayLoad>::Keys queryKeys = keys_;
-		DbCore<PayLoad>::DbStore& dbs = db_.dbStore();
-		std::regex regx(arg);
-		keys_.clear();
-		// iterate though those keys 
+		PatternCache::PatternPtr pattern = PatternCache::instance().get(arg);
 		std::cout << "\n\n Searching all keys with a description specified in a regular-expression pattern \"" << arg << "\"";
 		std::cout << "\n====================================================================================";
-		for (auto key : queryKeys)
+		auto matches = [&pattern](const Key&, const DbElement<T>& elem) { return pattern->matches(elem.descrip()); };
+		if (db_.indexing() && pattern->kind() != Pattern::regex && DbIndex<T>::canSearchDescrip(pattern->literal()))
 		{
-			if (std::regex_match(dbs[key].descrip(), regx))
-				keys_.push_back(key);
+			const DbIndex<T>& index = db_.index();
+			const std::string& literal = pattern->literal();
+			filterIndexed([&](size_t) { return index.countDescrip(literal); }, [&]() { return index.byDescrip(literal); }, matches);
 		}
+		else
+			filter(matches);  // iterate though current keys
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n    The matched keys: ";
@@ -362,7 +1111,7 @@ namespace NoSqlDb
 			std::cout << "\n    The matched description: \n";
 			for (auto key : keys_)
 			{
-				std::cout << "    " << key << ": " << dbs[key].descrip() << "\n";
+				std::cout << "    " << key << ": " << db_[key].descrip() << "\n";
 			}
 
 		}
@@ -374,20 +1123,22 @@ namespace NoSqlDb
 
 	//---- < Demonstrate all keys that match time interval in metadata section, where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template<typename T>
-	Query<T>& Query<T>::selectTimeInterval(DateTime dt1, DateTime dt2)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectTimeInterval(DateTime dt1, DateTime dt2)
 	{
 		std::cout << "\n\n Demonstrating all keys that match time interval in metadata section, where the specification is based on a regular-expression pattern";
-		DbCore<PayLoad>::Keys queryKeys = keys_;
-		DbCore<PayLoad>::DbStore& dbs = db_.dbStore();
-		keys_.clear();
-		for (auto key : queryKeys)
+		auto inInterval = [&dt1, &dt2](const Key&, const DbElement<T>& elem) {
+			DateTime dt = elem.dateTime();
+			return dt2 > dt && dt > dt1;
+		};
+		if (db_.indexing())
 		{
-			DbElement<PayLoad> dbElem = dbs[key];
-			DateTime dt = dbElem.dateTime();
-			if (dt2 > dt && dt > dt1)
-				keys_.push_back(key);
+			const DbIndex<T>& index = db_.index();
+			filterIndexed([&](size_t limit) { return index.countTime(dt1.ticks(), dt2.ticks(), limit); },
+				[&]() { return index.byTime(dt1.ticks(), dt2.ticks()); }, inInterval);
 		}
+		else
+			filter(inInterval);
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n    The matched keys: ";
@@ -398,7 +1149,7 @@ namespace NoSqlDb
 			std::cout << "\n\n    The matched time interval: \n\n";
 			for (auto key : keys_)
 			{
-				std::cout << "    " << key << ": " << dbs[key].dateTime().time() << "\n";
+				std::cout << "    " << key << ": " << db_[key].dateTime().time() << "\n";
 			}
 
 		}
@@ -411,24 +1162,25 @@ namespace NoSqlDb
 
 	//---- < Demonstrate all keys that match time in metadata section, where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template<typename T>
-	Query<T>& Query<T>::selectDate(DateTime dt1)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectDate(DateTime dt1)
 	{
 		std::cout << "\n\n Demonstrating all keys that match time in metadata section, where the specification is based on a regular-expression pattern";
-		// get key
-		DbCore<PayLoad>::Keys queryKeys = keys_;
-		DbCore<PayLoad>::DbStore& dbs = db_.dbStore();
-		keys_.clear();
 		DateTime dt2 = DateTime().now();
 		DateTime::Duration dur = DateTime::makeDuration(0, 0, 1, 0);
 		dt2 += dur;
-		for (auto key : queryKeys)
+		auto inInterval = [&dt1, &dt2](const Key&, const DbElement<T>& elem) {
+			DateTime dt = elem.dateTime();
+			return dt2 > dt && dt > dt1;
+		};
+		if (db_.indexing())
 		{
-			DbElement<PayLoad> dbElem = dbs[key];
-			DateTime dt = dbElem.dateTime();
-			if (dt2 > dt && dt > dt1)
-				keys_.push_back(key);
+			const DbIndex<T>& index = db_.index();
+			filterIndexed([&](size_t limit) { return index.countTime(dt1.ticks(), dt2.ticks(), limit); },
+				[&]() { return index.byTime(dt1.ticks(), dt2.ticks()); }, inInterval);
 		}
+		else
+			filter(inInterval);
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n    The matched keys: ";
@@ -439,7 +1191,7 @@ namespace NoSqlDb
 			std::cout << "\n\n    The matched time: \n\n";
 			for (auto key : keys_)
 			{
-				std::cout << "    " << key << ": " << dbs[key].dateTime().time() << "\n";
+				std::cout << "    " << key << ": " << db_[key].dateTime().time() << "\n";
 			}
 		}
 		else
@@ -450,47 +1202,113 @@ namespace NoSqlDb
 
 	//---- < Demonstrate the union of results of one or more previous queries, e.g., an "or"ing of multiple queries., where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template<typename T>
-	Query<T>& Query<T>::keysUnion(const Keys& keys)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::keysUnion(const Keys& keys)
 	{
 		std::cout << "\n\n  Demonstrating the union of results of one or more previous queries, e.g., an \" or \"ing of multiple queries., where the specification is based on a regular-expression pattern \n\n";
-		DbCore<std::string>::Keys copiedKeys = keys;
-		for (auto ckey : copiedKeys)
+		combine(keys, [](Ids::const_iterator a, Ids::const_iterator aEnd, Ids::const_iterator b, Ids::const_iterator bEnd, std::back_insert_iterator<Ids> out) {
+			std::set_union(a, aEnd, b, bEnd, out);
+		});
+		return *this;
+	}
+
+	//----< keep only current keys that are also in keys, an "and"ing of queries >
+
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::keysIntersect(const Keys& keys)
+	{
+		std::cout << "\n\n  Demonstrating the intersection of results of previous queries, an \" and \"ing of queries\n\n";
+		combine(keys, [](Ids::const_iterator a, Ids::const_iterator aEnd, Ids::const_iterator b, Ids::const_iterator bEnd, std::back_insert_iterator<Ids> out) {
+			std::set_intersection(a, aEnd, b, bEnd, out);
+		});
+		return *this;
+	}
+
+	//----< drop current keys that are in keys >-------------------------
+
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::keysDifference(const Keys& keys)
+	{
+		std::cout << "\n\n  Demonstrating the difference of results of previous queries\n\n";
+		combine(keys, [](Ids::const_iterator a, Ids::const_iterator aEnd, Ids::const_iterator b, Ids::const_iterator bEnd, std::back_insert_iterator<Ids> out) {
+			std::set_difference(a, aEnd, b, bEnd, out);
+		});
+		return *this;
+	}
+
+	//----< replace current keys with merge(current keys, keys) >--------
+	/*
+	*  - each distinct key of either side is hashed once to a RecordId,
+	*    numbered in order of first appearance, and merge walks the two
+	*    sorted id vectors once; keys are looked up again only to build
+	*    the result
+	*  - ids follow the current keys' order, so the result keeps it
+	*/
+	template<typename T, typename Db>
+	template<typename Merge>
+	void Query<T, Db>::combine(const Keys& keys, Merge merge)
+	{
+		this->keys();
+		IdMap ids;
+		ids.reserve(keys_.size() + keys.size());
+		std::vector<const Key*> byId;
+		byId.reserve(keys_.size() + keys.size());
+		Ids current = toIds(keys_, ids, byId);
+		Ids other = toIds(keys, ids, byId);
+		Ids merged;
+		merge(current.cbegin(), current.cend(), other.cbegin(), other.cend(), std::back_inserter(merged));
+		Keys result;
+		result.reserve(merged.size());
+		for (RecordId id : merged)
+			result.push_back(*byId[id]);
+		keys_.swap(result);
+	}
+
+	//----< sorted, duplicate-free ids of keys, interning new ones >-----
+
+	template<typename T, typename Db>
+	typename Query<T, Db>::Ids Query<T, Db>::toIds(const Keys& keys, IdMap& ids, std::vector<const Key*>& byId)
+	{
+		Ids result;
+		result.reserve(keys.size());
+		for (const Key& key : keys)
 		{
-			if (std::find(keys_.begin(), keys_.end(), ckey) != keys_.end())
-				continue;
-			else
-				keys_.push_back(ckey);
+			auto found = ids.emplace(&key, static_cast<RecordId>(byId.size()));
+			if (found.second)
+				byId.push_back(&key);
+			result.push_back(found.first->second);
 		}
-		return *this;
+		if (std::adjacent_find(result.begin(), result.end(), [](RecordId a, RecordId b) { return a >= b; }) != result.end())
+		{
+			std::sort(result.begin(), result.end());
+			result.erase(std::unique(result.begin(), result.end()), result.end());
+		}
+		return result;
 	}
 
 	//---- < Demonstrate all keys that match category in payload section, where the specification is based on a regular-expression pattern >-----------------------------------
 
-	template <typename T>
-	Query<T>& Query<T>::selectCategory(const std::string& arg)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectCategory(const std::string& arg)
 	{
-		DbCore<T>::DbStore dbStore_ = db_.dbStore();
-		DbCore<T>::Keys categorykeys = keys_;
-		keys_.clear();
 		std::cout << "\n\n Searching all keys with a category specified in a regular-expression pattern \"" << arg << "\"";
 		std::cout << "\n====================================================================================";
-		for (DbCore<T>::Key key : categorykeys)
+		auto hasCategory = [&arg](const Key&, const DbElement<T>& elem) {
+			const typename T::Categories& categories = elem.payLoad().categories();
+			return std::find(categories.begin(), categories.end(), arg) != categories.end();
+		};
+		if (db_.indexing())
 		{
-			DbElement<T> dbElem = dbStore_[key];
-			PayLoad dbElemPayload = dbElem.payLoad();
-			PayLoad::Categories categories = dbElemPayload.category();
-			for (auto category : categories)
-			{
-				if (category == arg)
-					keys_.push_back(key);
-			}
+			const DbIndex<T>& index = db_.index();
+			filterIndexed([&](size_t) { return index.countCategory(arg); }, [&]() { return index.byCategory(arg); }, hasCategory);
 		}
+		else
+			filter(hasCategory);
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n Found categories: \"" << arg << "\"\n";
 			std::cout << "The matched category keys are:\n";
-			for (DbCore<T>::Key categorykey : keys_)
+			for (const Key& categorykey : keys_)
 				std::cout << categorykey << " ";
 		}
 		else
@@ -500,31 +1318,21 @@ namespace NoSqlDb
 
 	//---- < Demonstrate all keys that match filepath in payload section, where the specification is based on a regular-expression pattern
 
-	template <typename T>
-	Query<T>& Query<T>::selectFilePath(const std::string& arg)
+	template<typename T, typename Db>
+	Query<T, Db>& Query<T, Db>::selectFilePath(const std::string& arg)
 	{
-		DbCore<T>::DbStore dbStore_ = db_.dbStore();
-		DbCore<T>::Keys filePathKeys = keys_;
-		keys_.clear();
 		std::cout << "\n\n Searching all keys with a category specified in a regular-expression pattern \"" << arg << "\"";
 		std::cout << "\n====================================================================================";
-		std::regex regx(arg);
-		for (DbCore<T>::Key filePathKey : filePathKeys)
-		{
-			DbElement<T> dbElem = dbStore_[filePathKey];
-			PayLoad dbElemPayload = dbElem.payLoad();
-			std::string filepath = dbElemPayload.filePath();
-			if (std::regex_match(filepath, regx))
-			{
-				keys_.push_back(filePathKey);
-			}
-		}
+		PatternCache::PatternPtr pattern = PatternCache::instance().get(arg);
+		filter([&pattern](const Key&, const DbElement<T>& elem) {
+			return pattern->matches(elem.payLoad().filePath());
+		});
 
 		if (keys_.size() > 0)
 		{
 			std::cout << "\n Found filepaths: \"" << arg << "\"\n";
 			std::cout << "The matched filepath keys are:\n";
-			for (DbCore<T>::Key filePathKey : keys_)
+			for (const Key& filePathKey : keys_)
 				std::cout << filePathKey << " ";
 		}
 		else
@@ -0,0 +1,283 @@
+#pragma once
+#ifndef _TASKPOOL_H_
+#define _TASKPOOL_H_
+/////////////////////////////////////////////////////////////////////////////////////
+// TaskPool.h - work-stealing thread pool for parallel queries                     //
+// ver 1.0                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* This package defines a single class, TaskPool, a fixed set of worker
+* threads that run tasks submitted to it.
+*
+* Each worker has its own task queue.  A worker takes tasks from the
+* back of its own queue and, when that is empty, steals from the front
+* of the others', so a worker that finishes early takes work from busy
+* ones instead of sitting idle.  Tasks submitted from a worker go on
+* that worker's queue; others are dealt out round-robin.
+*
+* parallelFor splits a range into chunks and runs them on at most
+* degree threads - the caller and degree - 1 pool tasks - which claim
+* chunks one at a time until none are left.  Each chunk's index is
+* passed to the function, so results kept per chunk can be merged in a
+* fixed order however the chunks were scheduled.  The caller runs pool
+* tasks while it waits, so parallelFor may be called from a pool task.
+*
+*   ----------------------------------------------------------
+*   - instance									: the shared pool, one worker per extra hardware thread
+*   - workers									: number of worker threads
+*   - submit									: queues a task
+*   - parallelFor								: runs f(chunk, begin, end) over chunks of [0, count)
+*
+* Required Files:
+* ---------------
+* TaskPool.h
+*
+* Build Process:
+* --------------
+* devenv Cpp11-NoSqlDb.sln /rebuild debug
+*
+* Maintenance History:
+* --------------------
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+namespace NoSqlDb
+{
+	/////////////////////////////////////////////////////////////////////
+	// TaskPool class
+	// - tasks must not throw; parallelFor catches what f throws and
+	//   rethrows the first exception in the caller
+
+	class TaskPool
+	{
+	public:
+		using Task = std::function<void()>;
+
+		explicit TaskPool(size_t workers);
+		TaskPool(const TaskPool&) = delete;
+		TaskPool& operator=(const TaskPool&) = delete;
+		~TaskPool();
+
+		static TaskPool& instance();
+		size_t workers() const { return threads_.size(); }
+		void submit(Task task);
+		template<typename F>
+		void parallelFor(size_t count, size_t degree, size_t chunks, F f);
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+		static const size_t npos = static_cast<size_t>(-1);
+
+		static size_t& current();
+		bool take(size_t self, Task& task);
+		void work(size_t self);
+
+		std::vector<std::unique_ptr<Queue>> queues_;
+		std::vector<std::thread> threads_;
+		std::atomic<size_t> next_;
+		std::atomic<size_t> queued_;
+		std::mutex sleepMutex_;
+		std::condition_variable wake_;
+		bool stop_ = false;
+	};
+
+	//----< start workers, each with its own queue >---------------------
+
+	inline TaskPool::TaskPool(size_t workers) : next_(0), queued_(0)
+	{
+		workers = std::max<size_t>(workers, 1);
+		for (size_t i = 0; i < workers; ++i)
+			queues_.push_back(std::unique_ptr<Queue>(new Queue));
+		for (size_t i = 0; i < workers; ++i)
+			threads_.emplace_back([this, i]() { work(i); });
+	}
+
+	//----< finish queued tasks, then join workers >---------------------
+
+	inline TaskPool::~TaskPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& t : threads_)
+			t.join();
+	}
+
+	//----< shared pool; the thread calling parallelFor is the extra one >
+
+	inline TaskPool& TaskPool::instance()
+	{
+		static TaskPool pool(std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+		return pool;
+	}
+
+	//----< index of the worker running on this thread, npos if none >---
+
+	inline size_t& TaskPool::current()
+	{
+		static thread_local size_t self = npos;
+		return self;
+	}
+
+	//----< queue task, on this worker's own queue when called from one >
+
+	inline void TaskPool::submit(Task task)
+	{
+		size_t self = current();
+		size_t target = self < queues_.size() ? self : next_++ % queues_.size();
+		{
+			std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+			queues_[target]->tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex_);
+			++queued_;
+		}
+		wake_.notify_one();
+	}
+
+	//----< take from the back of own queue, else steal from the front of another's >
+
+	inline bool TaskPool::take(size_t self, Task& task)
+	{
+		size_t count = queues_.size();
+		size_t start = self < count ? self : next_++ % count;
+		for (size_t i = 0; i < count; ++i)
+		{
+			Queue& queue = *queues_[(start + i) % count];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				continue;
+			if (i == 0 && self < count)
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			--queued_;
+			return true;
+		}
+		return false;
+	}
+
+	//----< worker loop: run tasks, sleep while there are none >---------
+
+	inline void TaskPool::work(size_t self)
+	{
+		current() = self;
+		for (;;)
+		{
+			Task task;
+			if (take(self, task))
+			{
+				task();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleepMutex_);
+			wake_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+			if (stop_ && queued_ == 0)
+				return;
+		}
+	}
+
+	//----< run f(chunk, begin, end) over chunks of [0, count) >---------
+	/*
+	*  - at most degree threads run f at once; with degree <= 1, or a
+	*    single chunk, f runs on the caller with no pool involvement
+	*  - chunk c covers [c * count / chunks, (c + 1) * count / chunks)
+	*/
+	template<typename F>
+	void TaskPool::parallelFor(size_t count, size_t degree, size_t chunks, F f)
+	{
+		chunks = std::max<size_t>(std::min(chunks, count), 1);
+		degree = std::min(degree, chunks);
+		if (degree <= 1)
+		{
+			for (size_t c = 0; c < chunks; ++c)
+				f(c, c * count / chunks, (c + 1) * count / chunks);
+			return;
+		}
+
+		std::atomic<size_t> nextChunk(0);
+		std::mutex doneMutex;
+		std::condition_variable doneCond;
+		size_t helpersDone = 0;
+		std::exception_ptr error;
+		auto claimChunks = [&]()
+		{
+			for (size_t c = nextChunk++; c < chunks; c = nextChunk++)
+			{
+				try
+				{
+					f(c, c * count / chunks, (c + 1) * count / chunks);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if (!error)
+						error = std::current_exception();
+				}
+			}
+		};
+		size_t helpers = degree - 1;
+		for (size_t i = 0; i < helpers; ++i)
+		{
+			submit([&]()
+			{
+				claimChunks();
+				std::lock_guard<std::mutex> lock(doneMutex);
+				++helpersDone;
+				doneCond.notify_one();
+			});
+		}
+		claimChunks();
+
+		// helpers still queued are run here, so waiting never needs a free
+		// worker; once no task is queued every helper has been taken
+		for (;;)
+		{
+			Task task;
+			if (take(current(), task))
+			{
+				task();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneCond.wait(lock, [&]() { return helpersDone == helpers; });
+			break;
+		}
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
+#endif
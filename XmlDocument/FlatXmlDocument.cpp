@@ -0,0 +1,318 @@
+/////////////////////////////////////////////////////////////////////////////////////
+// FlatXmlDocument.cpp - read-only XML document held in one array of nodes         //
+// ver 1.1                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <algorithm>
+#include "FlatXmlDocument.h"
+
+using namespace XmlProcessing;
+using NodeId = FlatXmlDocument::NodeId;
+using TagId = FlatXmlDocument::TagId;
+
+/////////////////////////////////////////////////////////////////////////////
+// Definitions of FlatXmlDocument methods
+
+//----< flatten an XmlDocument >---------------------------------------------
+
+FlatXmlDocument::FlatXmlDocument(XmlDocument& doc)
+{
+	flatten(*doc.docElement());
+}
+//----< flatten the tree under a doc element >-------------------------------
+
+FlatXmlDocument::FlatXmlDocument(AbstractXmlElement& docElement)
+{
+	flatten(docElement);
+}
+//----< parse XML string or file and flatten the result >--------------------
+
+FlatXmlDocument::FlatXmlDocument(const std::string& src, XmlDocument::sourceType srcType)
+{
+	XmlDocument doc(src, srcType);
+	flatten(*doc.docElement());
+}
+//----< copy every element of the tree into nodes_, in document order >------
+
+void FlatXmlDocument::flatten(AbstractXmlElement& docElement)
+{
+	nodes_.clear();
+	attribs_.clear();
+	text_.clear();
+	tags_.clear();
+	tagIds_.clear();
+	byTag_.clear();
+	intern("");  // noTag
+	add(docElement, none);
+}
+//----< append elem and its subtree, returning elem's id >-------------------
+/*
+*  Ids are indices, so nodes_ is only ever indexed here, never referenced
+*  across a call that may grow it.
+*/
+NodeId FlatXmlDocument::add(AbstractXmlElement& elem, NodeId parent)
+{
+	NodeId id = static_cast<NodeId>(nodes_.size());
+	Node node;
+	node.kind = docElement;
+	if (dynamic_cast<TaggedElement*>(&elem))
+		node.kind = taggedElement;
+	else if (dynamic_cast<TextElement*>(&elem))
+		node.kind = textElement;
+	else if (dynamic_cast<CommentElement*>(&elem))
+		node.kind = commentElement;
+	else if (dynamic_cast<ProcInstrElement*>(&elem))
+		node.kind = procInstrElement;
+	else if (dynamic_cast<XmlDeclarElement*>(&elem))
+		node.kind = xmlDeclarElement;
+	node.tag = intern(elem.tag());
+	node.parent = parent;
+	node.firstChild = node.nextSibling = none;
+
+	node.attribBegin = static_cast<uint32_t>(attribs_.size());
+	for (auto& attrib : elem.attributes())
+		attribs_.push_back(std::move(attrib));
+	node.attribEnd = static_cast<uint32_t>(attribs_.size());
+
+	node.textBegin = static_cast<uint32_t>(text_.size());
+	if (node.kind != taggedElement)  // a tagged element's value is its tag
+		text_ += elem.value();
+	node.textEnd = static_cast<uint32_t>(text_.size());
+	nodes_.push_back(node);
+	if (node.kind == taggedElement)
+		byTag_[node.tag].push_back(id);
+
+	NodeId prev = none;
+	for (auto& pChild : elem.children())
+	{
+		NodeId child = add(*pChild, id);
+		if (prev == none)
+			nodes_[id].firstChild = child;
+		else
+			nodes_[prev].nextSibling = child;
+		prev = child;
+	}
+	nodes_[id].end = static_cast<NodeId>(nodes_.size());
+	return id;
+}
+//----< return id of tag, adding it if new >---------------------------------
+
+TagId FlatXmlDocument::intern(const std::string& tag)
+{
+	auto iter = tagIds_.find(tag);
+	if (iter != tagIds_.end())
+		return iter->second;
+	TagId id = static_cast<TagId>(tags_.size());
+	tags_.push_back(tag);
+	tagIds_[tag] = id;
+	byTag_.emplace_back();
+	return id;
+}
+//----< look up id of tag, returning false if no node has it >---------------
+
+bool FlatXmlDocument::findTag(const std::string& tag, TagId& id) const
+{
+	auto iter = tagIds_.find(tag);
+	if (iter == tagIds_.end())
+		return false;
+	id = iter->second;
+	return true;
+}
+//----< return id of first tagged child of docElement, else none >-----------
+
+NodeId FlatXmlDocument::xmlRoot() const
+{
+	for (NodeId id = firstChild(docElem()); id != none; id = nextSibling(id))
+	{
+		if (kind(id) == taggedElement)
+			return id;
+	}
+	return none;
+}
+//----< return value, as the node's element would >--------------------------
+
+std::string FlatXmlDocument::value(NodeId id) const
+{
+	const Node& node = nodes_[id];
+	if (node.kind == taggedElement)
+		return tags_[node.tag];
+	return text_.substr(node.textBegin, node.textEnd - node.textBegin);
+}
+//----< return value of named attribute, else empty string >-----------------
+
+std::string FlatXmlDocument::attributeValue(NodeId id, const std::string& name) const
+{
+	for (uint32_t i = nodes_[id].attribBegin; i < nodes_[id].attribEnd; ++i)
+	{
+		if (attribs_[i].first == name)
+			return attribs_[i].second;
+	}
+	return "";
+}
+//----< find first element, in document order, with this tag >--------------
+/*
+*  found_ holds that element, else is empty.  A tag of "" matches any node.
+*/
+FlatXmlDocument& FlatXmlDocument::element(const std::string& tag)
+{
+	found_.clear();
+	selected_ = false;
+	TagId tagId = noTag;
+	bool anyTag = tag == "";
+	if (anyTag)
+		found_.push_back(docElem());  // the doc element's tag is ""
+	else if (findTag(tag, tagId) && byTag_[tagId].size() > 0)
+		found_.push_back(byTag_[tagId][0]);
+	return *this;
+}
+//----< find children of first element with this tag >-----------------------
+
+FlatXmlDocument& FlatXmlDocument::elements(const std::string& tag)
+{
+	element(tag);
+	if (found_.size() > 0)
+	{
+		NodeId parentId = found_[0];
+		found_.clear();                         // don't keep parent element
+		for (NodeId id = firstChild(parentId); id != none; id = nextSibling(id))
+			found_.push_back(id);
+	}
+	return *this;
+}
+//----< find descendents, with this tag, of first element last found >-------
+/*
+*  searches from xmlRoot if nothing was found, or the last results
+*  were selected, and returns all decendents if tag == ""
+*/
+FlatXmlDocument& FlatXmlDocument::descendents(const std::string& tag)
+{
+	NodeId from = found_.size() > 0 && !selected_ ? found_[0] : xmlRoot();
+	found_.clear();
+	selected_ = false;
+	TagId tagId = noTag;
+	bool anyTag = tag == "";
+	if (from == none || (!anyTag && !findTag(tag, tagId)))
+		return *this;
+	if (anyTag)
+	{
+		for (NodeId id = from + 1, last = end(from); id < last; ++id)
+			found_.push_back(id);
+		return *this;
+	}
+	const std::vector<NodeId>& ids = byTag_[tagId];  // in document order
+	auto first = std::upper_bound(ids.begin(), ids.end(), from);
+	auto last = std::lower_bound(first, ids.end(), end(from));
+	found_.insert(found_.end(), first, last);
+	return *this;
+}
+
+#ifdef TEST_FLATXMLDOCUMENT
+
+/////////////////////////////////////////////////////////////////////////////
+// Test Functions
+
+using sPtr = XmlDocument::sPtr;
+
+//----< build an XmlDocument for testing >-----------------------------------
+
+XmlDocument buildDocument()
+{
+	sPtr pRoot = makeTaggedElement("root");
+	XmlDocument doc(XmlProcessing::makeDocElement(pRoot));
+
+	sPtr child1 = makeTaggedElement("child1");
+	child1->addChild(makeTextElement("child1 text"));
+	child1->addAttrib("id", "c1");
+	sPtr grandChild11 = makeTaggedElement("grandChild11");
+	grandChild11->addChild(makeTextElement("grandchild11 text"));
+	child1->addChild(grandChild11);
+	pRoot->addChild(child1);
+	sPtr secondChild1 = makeTaggedElement("child1");
+	secondChild1->addChild(makeTextElement("text of second child1"));
+	child1->addChild(secondChild1);
+
+	sPtr child2 = makeTaggedElement("child2");
+	child2->addChild(makeTextElement("child2 text"));
+	pRoot->addChild(child2);
+	return doc;
+}
+//----< show tags, or values of untagged nodes >-----------------------------
+
+void show(const FlatXmlDocument& flat, const std::vector<NodeId>& found)
+{
+	if (found.size() == 0)
+		std::cout << "\n  found nothing";
+	for (NodeId id : found)
+	{
+		if (flat.tag(id) != "")
+			std::cout << "\n  found: " << flat.tag(id);
+		else
+			std::cout << "\n  found: " << flat.value(id);
+	}
+	std::cout << "\n";
+}
+//----< do flat queries find the elements XmlDocument finds? >---------------
+
+bool sameAs(const FlatXmlDocument& flat, const std::vector<NodeId>& ids, const std::vector<sPtr>& elems)
+{
+	if (ids.size() != elems.size())
+		return false;
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		if (flat.tag(ids[i]) != elems[i]->tag() || flat.value(ids[i]) != elems[i]->value())
+			return false;
+	}
+	return true;
+}
+//----< test stub >----------------------------------------------------------
+
+int main()
+{
+	title("Testing FlatXmlDocument class");
+
+	XmlDocument doc = buildDocument();
+	FlatXmlDocument flat(doc);
+	std::cout << doc.toString() << "\n";
+	std::cout << "\n  size of document = " << flat.size() << ", XmlDocument size = " << doc.size() << "\n";
+
+	title("testing DFS from xmlRoot - printing tags");
+	flat.DFS(flat.xmlRoot(), [&](NodeId id) {
+		if (flat.kind(id) == FlatXmlDocument::taggedElement)
+			std::cout << "\n  " << flat.tag(id);
+	});
+	std::cout << "\n";
+
+	bool ok = flat.size() == doc.size();
+	title("testing element(\"child1\")");
+	show(flat, flat.element("child1").select());
+	ok = ok && flat.attributeValue(flat.select()[0], "id") == "c1";
+	ok = ok && sameAs(flat, flat.select(), { doc.element("child1").select()[0] });
+
+	title("testing elements(\"child1\")");
+	show(flat, flat.elements("child1").select());
+	ok = ok && sameAs(flat, flat.select(), doc.elements("child1").select());
+
+	title("testing descendents(\"child1\")");
+	show(flat, flat.descendents("child1").select());
+	ok = ok && sameAs(flat, flat.select(), doc.descendents("child1").select());
+
+	title("testing element(\"child1\").descendents()");
+	show(flat, flat.element("child1").descendents().select());
+	ok = ok && sameAs(flat, flat.select(), doc.element("child1").descendents().select());
+
+	title("testing element(\"foobar\")");
+	show(flat, flat.element("foobar").select());
+	ok = ok && flat.select().size() == 0;
+
+	std::cout << "\n  flat queries " << (ok ? "match" : "do not match") << " XmlDocument queries\n\n";
+	return ok ? 0 : 1;
+}
+
+#endif
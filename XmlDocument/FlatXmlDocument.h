@@ -0,0 +1,156 @@
+#ifndef FLATXMLDOCUMENT_H
+#define FLATXMLDOCUMENT_H
+/////////////////////////////////////////////////////////////////////////////////////
+// FlatXmlDocument.h - read-only XML document held in one array of nodes           //
+// ver 1.1                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* FlatXmlDocument is a read-only alternative to XmlDocument for code
+* that searches a document rather than edits it.  Its nodes sit in one
+* vector in document (depth first) order, so:
+* - a node is a NodeId, an index into that vector
+* - each node holds the ids of its parent, first child and next sibling,
+*   and the id one past its last descendent, so a subtree is the range
+*   [n, end(n)) and walking it is a loop over consecutive nodes
+* - tags are interned, and each node holds its tag's TagId, so matching
+*   a tag compares two integers
+* - each tag indexes the ids of its elements, in document order, so
+*   finding a tag's elements in a subtree is two binary searches
+* - text, comments and attributes are held in shared pools
+*
+* The queries mirror XmlDocument's - element, elements, descendents and
+* select, and DFS taking a callable object - but keep their results as
+* NodeIds in a vector that is reused, so a query allocates nothing once
+* that vector has grown to the size of its results.  As with XmlDocument,
+* a query after select() starts afresh; the reference select() returns
+* is good until that next query.
+*
+* Public Interface:
+* -----------------
+*   FlatXmlDocument flat(xmlDoc);              // flatten an XmlDocument
+*   FlatXmlDocument flat(*pDocElement);        // flatten a tree
+*   FlatXmlDocument flat(src, XmlDocument::file);  // parse and flatten
+*   auto& ids = flat.element("foo").descendents("bar").select();
+*   for (NodeId id : ids) std::cout << flat.tag(id) << flat.value(id);
+*   flat.DFS(flat.xmlRoot(), [&](NodeId id) { ... });
+*
+* Required Files:
+* ---------------
+*   - FlatXmlDocument.h, FlatXmlDocument.cpp
+*   - XmlDocument.h, XmlDocument.cpp, XmlElement.h, XmlElement.cpp
+*
+* Build Process:
+* --------------
+*   devenv XmlParser.sln /debug rebuild
+*
+* Maintenance History:
+* --------------------
+* ver 1.1 : 18 Oct 2026
+* - added tag index, nodesWithTag, used by element, descendents and XmlPath
+* - added construction from a doc element
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "XmlDocument.h"
+
+namespace XmlProcessing
+{
+	///////////////////////////////////////////////////////////////////////////
+	// FlatXmlDocument class
+
+	class FlatXmlDocument
+	{
+	public:
+		using NodeId = uint32_t;
+		using TagId = uint32_t;
+		using Attribute = AbstractXmlElement::Attribute;
+		enum Kind : unsigned char { docElement, taggedElement, textElement, commentElement, procInstrElement, xmlDeclarElement };
+		static const NodeId none = UINT32_MAX;
+		static const TagId noTag = 0;                       // tag of every node but tagged elements
+
+		explicit FlatXmlDocument(XmlDocument& doc);
+		explicit FlatXmlDocument(AbstractXmlElement& docElement);
+		FlatXmlDocument(const std::string& src, XmlDocument::sourceType srcType = XmlDocument::str);
+
+		// node access, ids must be less than end(docElem())
+
+		NodeId docElem() const { return 0; }
+		NodeId xmlRoot() const;
+		Kind kind(NodeId id) const { return nodes_[id].kind; }
+		TagId tagId(NodeId id) const { return nodes_[id].tag; }
+		const std::string& tag(NodeId id) const { return tags_[nodes_[id].tag]; }
+		std::string value(NodeId id) const;
+		NodeId parent(NodeId id) const { return nodes_[id].parent; }
+		NodeId firstChild(NodeId id) const { return nodes_[id].firstChild; }
+		NodeId nextSibling(NodeId id) const { return nodes_[id].nextSibling; }
+		NodeId end(NodeId id) const { return nodes_[id].end; }
+		size_t attributeCount(NodeId id) const { return nodes_[id].attribEnd - nodes_[id].attribBegin; }
+		const Attribute& attribute(NodeId id, size_t i) const { return attribs_[nodes_[id].attribBegin + i]; }
+		std::string attributeValue(NodeId id, const std::string& name) const;
+		bool findTag(const std::string& tag, TagId& id) const;
+		const std::vector<NodeId>& nodesWithTag(TagId id) const { return byTag_[id]; }
+
+		// queries, as XmlDocument's, chained through the found collection
+
+		FlatXmlDocument& element(const std::string& tag);
+		FlatXmlDocument& elements(const std::string& tag);
+		FlatXmlDocument& descendents(const std::string& tag = "");
+		const std::vector<NodeId>& select() { selected_ = true; return found_; }
+
+		size_t size() const { return nodes_.size() - 1; }   // doesn't count docElement
+		template<typename CallObj>
+		void DFS(NodeId from, CallObj co) const;
+		template<typename CallObj>
+		void DFS(CallObj co) const { DFS(docElem(), co); }
+	private:
+		struct Node
+		{
+			Kind kind;
+			TagId tag;
+			NodeId parent;
+			NodeId firstChild;
+			NodeId nextSibling;
+			NodeId end;
+			uint32_t attribBegin;
+			uint32_t attribEnd;
+			uint32_t textBegin;
+			uint32_t textEnd;
+		};
+
+		void flatten(AbstractXmlElement& docElement);
+		NodeId add(AbstractXmlElement& elem, NodeId parent);
+		TagId intern(const std::string& tag);
+
+		std::vector<Node> nodes_;
+		std::vector<Attribute> attribs_;
+		std::string text_;
+		std::vector<std::string> tags_;
+		std::unordered_map<std::string, TagId> tagIds_;
+		std::vector<std::vector<NodeId>> byTag_;  // ids of tagged elements, by TagId
+		std::vector<NodeId> found_;
+		bool selected_ = false;  // found_ was returned by select, so queries ignore it
+	};
+
+	//----< apply co to each node of from's subtree in document order >--------
+
+	template<typename CallObj>
+	void FlatXmlDocument::DFS(NodeId from, CallObj co) const
+	{
+		for (NodeId id = from, last = nodes_[from].end; id < last; ++id)
+			co(id);
+	}
+}
+#endif
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.cpp - Reads words from a file                        //
-//  ver 1.9                                                        //
+//  ver 2.1                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -16,6 +16,14 @@
 #include <assert.h>
 #include "Tokenizer.h"
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TOKENIZER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 //----< constructor may be called with no argument >-----------
 
 Toker::Toker(const std::string& src, bool isFile)
@@ -321,6 +329,294 @@ std::string Toker::getTok()
 	} while (!isTokEnd() || tok.length() == 0);
 	return tok;
 }
+//
+//----< BufferToker character classes, ASCII only >------------
+/*
+*  - unlike isspace and isalpha these are safe for chars above 127,
+*    which are neither space nor identifier characters
+*/
+namespace
+{
+	inline bool isSpaceChar(int ch)
+	{
+		return ch == ' ' || (ch >= '\t' && ch <= '\r');
+	}
+
+	inline bool isIdentChar(int ch)
+	{
+		return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+	}
+
+	inline bool isXmlSingleCharTok(int ch)
+	{
+		switch (ch)
+		{
+		case '<': case '>': case '!': case '(': case ')': case '[': case ']':
+		case '{': case '}': case ';': case '.': case '\n':
+			return true;
+		default:
+			return false;
+		}
+	}
+
+#ifdef TOKENIZER_SSE2
+	//----< index of the lowest set bit of a nonzero mask >--------
+
+	inline unsigned firstBit(int mask)
+	{
+#ifdef _MSC_VER
+		unsigned long first;
+		_BitScanForward(&first, static_cast<unsigned long>(mask));
+		return static_cast<unsigned>(first);
+#else
+		return static_cast<unsigned>(__builtin_ctz(static_cast<unsigned>(mask)));
+#endif
+	}
+
+	//----< bytes of block in [lo, hi], both below 128 >-----------
+
+	inline __m128i inRange(const __m128i& block, char lo, char hi)
+	{
+		return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8(hi + 1)));
+	}
+
+	//----< skip sixteen byte blocks while mask(block) is all set >
+
+	template<typename Mask>
+	const char* skipBlocks(const char* from, const char* to, Mask mask)
+	{
+		while (to - from >= 16)
+		{
+			int outside = ~mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))) & 0xFFFF;
+			if (outside != 0)
+				return from + firstBit(outside);
+			from += 16;
+		}
+		return from;
+	}
+#endif
+}
+//----< compare token with a null terminated string >----------
+
+bool BufferToker::Token::operator==(const char* s) const
+{
+	size_t i = 0;
+	for (; i < size; ++i)
+	{
+		if (s[i] != data[i] || s[i] == '\0')
+			return false;
+	}
+	return s[i] == '\0';
+}
+//----< tokenize the characters in [begin, end) >--------------
+
+BufferToker::BufferToker(const char* b, const char* e) : begin(b), end(e), pos(b) {}
+
+//----< tokenize src in place; src must outlive the toker >----
+
+BufferToker::BufferToker(const std::string& src)
+	: begin(src.data()), end(src.data() + src.size()), pos(src.data()) {}
+
+//----< number of newlines read so far >-----------------------
+
+int BufferToker::lines() const
+{
+	int count = 0;
+	for (const char* p = begin; p < pos; ++p)
+	{
+		if (*p == '\n')
+			++count;
+	}
+	return count;
+}
+//----< step back over the character just read >---------------
+
+void BufferToker::putback(char ch)
+{
+	if (pos == begin || pos[-1] != ch)
+		throw std::exception("BufferToker can only put back the character just read");
+	--pos;
+}
+//----< first ch in [from, to), or to if there is none >-------
+/*
+*  - compares sixteen characters at a time with SSE2
+*/
+const char* BufferToker::find(const char* from, const char* to, char ch)
+{
+#ifdef TOKENIZER_SSE2
+	const __m128i target = _mm_set1_epi8(ch);
+	while (to - from >= 16)
+	{
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, target));
+		if (mask != 0)
+			return from + firstBit(mask);
+		from += 16;
+	}
+#endif
+	while (from < to && *from != ch)
+		++from;
+	return from;
+}
+//----< first char in [from, to) that is not an identifier char >
+
+const char* BufferToker::skipIdent(const char* from, const char* to)
+{
+#ifdef TOKENIZER_SSE2
+	from = skipBlocks(from, to, [](const __m128i& block) {
+		__m128i letter = inRange(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z');
+		__m128i digit = inRange(block, '0', '9');
+		__m128i underscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+		return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore));
+	});
+	if (from < to && !isIdentChar(static_cast<unsigned char>(*from)))
+		return from;
+#endif
+	while (from < to && isIdentChar(static_cast<unsigned char>(*from)))
+		++from;
+	return from;
+}
+//----< first char in [from, to) that is newline or not space >
+
+const char* BufferToker::skipSpace(const char* from, const char* to)
+{
+#ifdef TOKENIZER_SSE2
+	from = skipBlocks(from, to, [](const __m128i& block) {
+		__m128i blank = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+		__m128i control = _mm_andnot_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), inRange(block, '\t', '\r'));
+		return _mm_movemask_epi8(_mm_or_si128(blank, control));
+	});
+#endif
+	while (from < to && *from != '\n' && isSpaceChar(static_cast<unsigned char>(*from)))
+		++from;
+	return from;
+}
+//----< remove contiguous white space except for newline >-----
+
+void BufferToker::stripWhiteSpace()
+{
+	pos = skipSpace(pos, end);
+}
+//----< is this the end of a token? >--------------------------
+
+bool BufferToker::isTokEnd() const
+{
+	int nextCh = next();
+	int currCh = static_cast<unsigned char>(curr());
+	if (isSpaceChar(nextCh))
+		return true;
+	if (isXmlSingleCharTok(nextCh) || isXmlSingleCharTok(currCh))
+		return true;
+	if (isIdentChar(currCh) != isIdentChar(nextCh))
+		return true;
+	return isFileEnd();
+}
+//----< return comment starting at the character just read >--
+/*
+*  - a C++ comment ends before the next unescaped newline, a C
+*    comment after the next unescaped star-slash, as in Toker
+*/
+BufferToker::Token BufferToker::eatComment(bool aCppComment)
+{
+	const char* start = pos - 1;
+	const char* stop = pos;
+	while (true)
+	{
+		stop = find(stop, end, aCppComment ? '\n' : '/');
+		if (stop == end)
+			break;
+		if (aCppComment && stop[-1] != '\\')
+			break;
+		if (!aCppComment && stop - start >= 2 && stop[-1] == '*' && (stop - start == 2 || stop[-2] != '\\'))
+		{
+			++stop;
+			break;
+		}
+		++stop;
+	}
+	pos = stop;
+	return Token(start, stop - start);
+}
+//----< return quote starting at the character just read >----
+/*
+*  - a quote char ends the quote unless a lone backslash precedes it
+*/
+BufferToker::Token BufferToker::eatQuote(char quote)
+{
+	const char* start = pos - 1;
+	const char* stop = pos;
+	while (true)
+	{
+		stop = find(stop, end, quote);
+		if (stop == end)
+			throw std::exception("missing end of quote");
+		char currCh = stop[-1];
+		char prevCh = stop - begin > 1 ? stop[-2] : 0;
+		if (prevCh == '\\' || currCh != '\\')
+			break;
+		++stop;
+	}
+	pos = stop + 1;
+	return Token(start, pos - start);
+}
+//----< read token from buffer, empty at end of buffer >-------
+/*
+*  - once an identifier char is read, the rest of its run is taken
+*    whole: identifier chars start no comment or quote, and a token
+*    ends only where the run does
+*/
+BufferToker::Token BufferToker::getTok()
+{
+	if (pos != begin)  // like Toker, which has no lookahead before its first read
+	{
+		stripWhiteSpace();
+		if (pos < end && isXmlSingleCharTok(static_cast<unsigned char>(*pos)))
+			return Token(pos++, 1);
+	}
+	const char* tokBegin = pos;
+	size_t size = 0;
+	do
+	{
+		if (isFileEnd())
+			return Token(tokBegin, size);
+		++pos;
+		char currCh = curr();
+		if (prev() != '\\' && currCh == '/' && (next() == '*' || next() == '/'))
+		{
+			if (size > 0)
+			{
+				--pos;
+				return Token(tokBegin, size);
+			}
+			Token comment = eatComment(next() == '/');
+			if (doReturnComments)
+				return comment;
+			continue;
+		}
+		if (prev() != '\\' && (currCh == '\'' || currCh == '\"'))
+		{
+			if (size > 0)
+			{
+				--pos;
+				return Token(tokBegin, size);
+			}
+			return eatQuote(currCh);
+		}
+		if (!isSpaceChar(static_cast<unsigned char>(currCh)))
+		{
+			if (size == 0)
+				tokBegin = pos - 1;
+			++size;
+			if (isIdentChar(static_cast<unsigned char>(currCh)))
+			{
+				const char* runEnd = skipIdent(pos, end);
+				size += runEnd - pos;
+				pos = runEnd;
+			}
+		}
+	} while (!isTokEnd() || size == 0);
+	return Token(tokBegin, size);
+}
 //----< test stub >--------------------------------------------
 
 #ifdef TEST_TOKENIZER
@@ -338,6 +634,16 @@ int main(int argc, char* argv[])
 		std::cout << "  " << tok;
 	} while (tok != "");
 	std::cout << "\n\n";
+	// collecting tokens from a buffer, in place
+	std::string xml = "<doc a=\"x y\"><!-- note --><elem>text</elem></doc>";
+	BufferToker bt(xml);
+	BufferToker::Token btok;
+	do
+	{
+		btok = bt.getTok();
+		std::cout << "  " << btok.str();
+	} while (!btok.empty());
+	std::cout << "\n\n";
 	// collecting tokens from files, named on the command line
 	if (argc < 2)
 	{
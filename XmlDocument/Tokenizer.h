@@ -2,7 +2,7 @@
 #define TOKENIZER_H
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.h - Reads words from a file                          //
-//  ver 1.9                                                        //
+//  ver 2.1                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -26,6 +26,15 @@ Toker::setMode(Toker::xml), or Toker::setSingleCharTokens(somestring);
 A tokenizer is an important part of a scanner, used to read and interpret
 source code or XML.
 
+The module also defines BufferToker, which returns the same tokens as
+Toker in xml mode, but scans a contiguous buffer - a string or a mapped
+file - in place.  Each token is a Token, a pointer and length into that
+buffer, so tokenizing allocates nothing; the buffer must outlive the
+tokens.  Where the target supports SSE2, sixteen characters are
+classified at a time to find the end of a quote or comment, to skip
+white space, and to skip the rest of a word once its first character
+is read.  Punctuation is still read a character at a time.
+
 Public Interface:
 =================
 Toker t;                        // create tokenizer instance
@@ -35,6 +44,10 @@ string tok = t.getTok();      // extract first token
 int numLines = t.lines();       // return number of lines encountered
 t.lines() = 0;                  // reset line count
 
+BufferToker bt(someString);     // tokenize someString in place, xml mode
+BufferToker::Token tok = bt.getTok();  // "" at end of buffer
+std::string word = tok.str();   // copy token out of the buffer
+
 Build Process:
 ==============
 Required files
@@ -45,6 +58,10 @@ Build commands (either one)
 
 Maintenance History:
 ====================
+ver 2.1 : 18 Oct 2026
+- BufferToker skips words and white space sixteen characters at a time
+ver 2.0 : 18 Oct 2026
+- added BufferToker, an allocation-free xml mode tokenizer over a buffer
 ver 1.9 : 18 Mar 10
 - added thrown exception if get to end of file in eatQuote()
 ver 1.8 : 02 Mar 10
@@ -152,4 +169,54 @@ inline int& Toker::lines() { return numLines; }
 
 inline int Toker::braceLevel() { return braceCount; }
 
+///////////////////////////////////////////////////////////////////////
+// BufferToker class
+// - tokenizes [begin, end) the way Toker does in xml mode
+// - putback only steps back over the character just read, which is
+//   all XmlParts needs
+
+class BufferToker
+{
+public:
+	struct Token
+	{
+		const char* data = nullptr;
+		size_t size = 0;
+
+		Token() {}
+		Token(const char* d, size_t n) : data(d), size(n) {}
+		bool empty() const { return size == 0; }
+		std::string str() const { return std::string(data, size); }
+		explicit operator std::string() const { return str(); }
+		bool operator==(const char* s) const;
+		bool operator!=(const char* s) const { return !(*this == s); }
+	};
+
+	BufferToker(const char* begin, const char* end);
+	explicit BufferToker(const std::string& src);
+	Token getTok();
+	void returnComments(bool doReturn = true) { doReturnComments = doReturn; }
+	bool isFileEnd() const { return pos == end; }
+	int lines() const;
+	void putback(char ch);
+
+private:
+	const char* begin;
+	const char* end;
+	const char* pos;
+	bool doReturnComments = false;
+
+	// private helper functions
+	int next() const { return pos < end ? static_cast<unsigned char>(*pos) : -1; }
+	char curr() const { return pos > begin ? pos[-1] : 0; }
+	char prev() const { return pos - begin > 1 ? pos[-2] : 0; }
+	void stripWhiteSpace();
+	bool isTokEnd() const;
+	Token eatComment(bool aCppComment);
+	Token eatQuote(char quote);
+	static const char* find(const char* from, const char* to, char ch);
+	static const char* skipIdent(const char* from, const char* to);
+	static const char* skipSpace(const char* from, const char* to);
+};
+
 #endif
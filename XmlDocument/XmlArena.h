@@ -0,0 +1,128 @@
+#ifndef XMLARENA_H
+#define XMLARENA_H
+/////////////////////////////////////////////////////////////////////////////////////
+// XmlArena.h - per-document memory for parsed XML elements                        //
+// ver 1.0                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* XmlParser builds every element of a document in one XmlArena, so a
+* parse makes one allocation per chunk of elements rather than one
+* per element.  The elements of a document live and die together, so
+* the arena only bumps a pointer: deallocate does nothing, and all of
+* the chunks are freed when the arena goes away.
+*
+* XmlArenaAllocator<T> is a standard allocator drawing on an XmlArena.
+* XmlParser hands it to std::allocate_shared, so each element and its
+* shared_ptr control block sit in one arena block.  Each control block holds
+* a shared_ptr to the arena, so the arena lives until the last element
+* of its document is released.  Memory of elements removed from a
+* document is not reused until the whole document is gone.
+*
+* An arena is filled by one thread, while its document is parsed.
+* Releasing elements later, from any thread, never touches it.
+*
+* Required Files:
+* ---------------
+*   - XmlArena.h
+*
+* Build Process:
+* --------------
+*   devenv XmlParser.sln /debug rebuild
+*
+* Maintenance History:
+* --------------------
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+
+namespace XmlProcessing
+{
+	/////////////////////////////////////////////////////////////////////////////
+	// XmlArena - hands out blocks from large chunks, freeing them all at once
+
+	class XmlArena
+	{
+	public:
+		static const size_t alignment = 16;
+
+		explicit XmlArena(size_t chunkBytes = 16 * 1024) : chunkBytes_(chunkBytes) {}
+		XmlArena(const XmlArena&) = delete;
+		XmlArena& operator=(const XmlArena&) = delete;
+		~XmlArena();
+		void* allocate(size_t bytes);
+		size_t chunks() const { return chunks_.size(); }
+	private:
+		size_t chunkBytes_;
+		std::vector<char*> chunks_;
+		char* next_ = nullptr;
+		char* end_ = nullptr;
+	};
+
+	//----< free every chunk >---------------------------------------------------
+
+	inline XmlArena::~XmlArena()
+	{
+		for (char* chunk : chunks_)
+			::operator delete(chunk);
+	}
+	//----< bump allocate, starting a new chunk when this one is full >----------
+	/*
+	*  blocks larger than a chunk get a chunk of their own
+	*/
+	inline void* XmlArena::allocate(size_t bytes)
+	{
+		bytes = (bytes + alignment - 1) / alignment * alignment;
+		if (static_cast<size_t>(end_ - next_) < bytes)
+		{
+			size_t size = bytes > chunkBytes_ ? bytes : chunkBytes_;
+			chunks_.reserve(chunks_.size() + 1);
+			next_ = static_cast<char*>(::operator new(size));
+			end_ = next_ + size;
+			chunks_.push_back(next_);
+		}
+		void* block = next_;
+		next_ += bytes;
+		return block;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// XmlArenaAllocator - allocator for std::allocate_shared
+
+	template<typename T>
+	class XmlArenaAllocator
+	{
+	public:
+		using value_type = T;
+
+		XmlArenaAllocator(std::shared_ptr<XmlArena> pArena) : pArena_(std::move(pArena)) {}
+		template<typename U>
+		XmlArenaAllocator(const XmlArenaAllocator<U>& alloc) : pArena_(alloc.arena()) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(pArena_->allocate(count * sizeof(T))); }
+		void deallocate(T*, size_t) {}
+		const std::shared_ptr<XmlArena>& arena() const { return pArena_; }
+	private:
+		static_assert(alignof(T) <= XmlArena::alignment, "type is aligned more strictly than XmlArena blocks");
+		std::shared_ptr<XmlArena> pArena_;
+	};
+
+	template<typename T, typename U>
+	bool operator==(const XmlArenaAllocator<T>& a, const XmlArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+
+	template<typename T, typename U>
+	bool operator!=(const XmlArenaAllocator<T>& a, const XmlArenaAllocator<U>& b) { return !(a == b); }
+}
+#endif
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////
 // XmlDocument.cpp - a container of XmlElement nodes             //
-// Ver 2.5                                                       //
+// Ver 2.8                                                       //
 // Application: Help for CSE687 Pr#2, Spring 2015                //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -11,6 +11,8 @@
 #include <functional>
 #include "XmlDocument.h"
 #include "XmlParser.h"
+#include "FlatXmlDocument.h"
+#include "XmlPath.h"
 #include "../XmlUtilities/XmlUtilities.h"
 
 using namespace XmlProcessing;
@@ -22,7 +24,7 @@ using sPtr = std::shared_ptr < AbstractXmlElement >;
 XmlProcessing::XmlDocument::XmlDocument(const std::string& src, sourceType srcType)
 {
 	XmlParser parser(src, (XmlParser::sourceType) srcType);
-	XmlDocument* pDoc = parser.buildDocument();
+	std::unique_ptr<XmlDocument> pDoc(parser.buildDocument());
 	*this = std::move(*pDoc);
 }
 //----< move constructor >---------------------------------------------------
@@ -31,6 +33,7 @@ XmlDocument::XmlDocument(XmlDocument&& doc)
 {
 	pDocElement_ = doc.pDocElement_;
 	doc.pDocElement_ = nullptr;
+	pIndex_ = std::move(doc.pIndex_);
 }
 //----< move assignment >----------------------------------------------------
 
@@ -39,6 +42,7 @@ XmlDocument& XmlDocument::operator=(XmlDocument&& doc)
 	if (&doc == this) return *this;
 	pDocElement_ = doc.pDocElement_;
 	doc.pDocElement_ = nullptr;
+	pIndex_ = std::move(doc.pIndex_);
 	return *this;
 }
 //----< return std::shared_ptr to XML root >---------------------------------
@@ -56,6 +60,7 @@ sPtr XmlDocument::xmlRoot()
 
 bool XmlDocument::xmlRoot(sPtr pRoot)
 {
+	reindex();
 	return pDocElement_->addChild(pRoot);
 }
 //----< find element(s) with this tag >--------------------------------------
@@ -130,11 +135,82 @@ size_t XmlDocument::size()
 	found_.clear();
 	return size_;
 }
+/////////////////////////////////////////////////////////////////////////////
+// Path queries
+
+//----< tag index for path queries >-----------------------------------------
+/*
+*  elems[id] is the element that flat numbers id
+*/
+struct XmlDocument::Index
+{
+	explicit Index(const sPtr& pDocElement);
+	void collect(const sPtr& pElem);
+
+	FlatXmlDocument flat;
+	std::vector<sPtr> elems;
+};
+//----< flatten the tree, keeping its elements in the same order >-----------
+
+XmlDocument::Index::Index(const sPtr& pDocElement) : flat(*pDocElement)
+{
+	elems.reserve(flat.size() + 1);
+	collect(pDocElement);
+}
+//----< append pElem and its subtree in document order, as flat does >-------
+
+void XmlDocument::Index::collect(const sPtr& pElem)
+{
+	elems.push_back(pElem);
+	for (auto& pChild : pElem->children())
+		collect(pChild);
+}
+//----< return the tag index, building it on first use >---------------------
+/*
+*  Only the first query builds the index: others arriving meanwhile wait
+*  for it on indexLock_, and later ones just load the pointer.
+*/
+std::shared_ptr<const XmlDocument::Index> XmlDocument::index() const
+{
+	std::shared_ptr<const Index> pIndex = std::atomic_load(&pIndex_);
+	if (pIndex)
+		return pIndex;
+	std::lock_guard<std::mutex> lock(indexLock_);
+	pIndex = std::atomic_load(&pIndex_);
+	if (!pIndex)
+	{
+		pIndex = std::make_shared<const Index>(pDocElement_);
+		std::atomic_store(&pIndex_, pIndex);
+	}
+	return pIndex;
+}
+//----< return elements path selects, in document order >--------------------
+
+std::vector<sPtr> XmlDocument::select(const XmlPath& path) const
+{
+	std::vector<sPtr> found;
+	if (!pDocElement_)
+		return found;
+	std::shared_ptr<const Index> pIndex = index();
+	std::vector<FlatXmlDocument::NodeId> ids = path.select(pIndex->flat);
+	found.reserve(ids.size());
+	for (auto id : ids)
+		found.push_back(pIndex->elems[id]);
+	return found;
+}
+//----< drop the tag index, so the next path query rebuilds it >-------------
+
+void XmlDocument::reindex()
+{
+	std::atomic_store(&pIndex_, std::shared_ptr<const Index>());
+}
 //----< return XML string representation of XmlDocument >--------------------
 
-std::string XmlDocument::toString()
+std::string XmlDocument::toString(XmlOut::Layout layout)
 {
-	return pDocElement_->toString();
+	XmlOut out(layout);
+	write(out);
+	return std::move(out.buffer());
 }
 
 std::string enQuote(std::string s) { return "\"" + s + "\""; }
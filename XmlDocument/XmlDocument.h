@@ -2,7 +2,7 @@
 #define XMLDOCUMENT_H
 ///////////////////////////////////////////////////////////////////
 // XmlDocument.h - a container of XmlElement nodes               //
-// Ver 2.5                                                       //
+// Ver 2.8                                                       //
 // Application: Help for CSE687 Pr#2, Spring 2015                //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -44,6 +44,15 @@
 *
 * Maintenance History:
 * --------------------
+* ver 2.8 : 18 Oct 2026
+* - added select(const XmlPath&), path queries on a tag index built once,
+*   that change no document state and may run on many threads at once
+* - added reindex()
+* ver 2.7 : 18 Oct 2026
+* - added write(XmlOut&), and a compact layout for toString
+* ver 2.6 : 18 Oct 2026
+* - parsed elements are made in a per-document XmlArena, see XmlParser
+* - no longer leaks the document built by XmlParser in the constructor
 * ver 2.5 : 02 Feb 2018
 * - completed attribute handling by adding two new methods to AbstractXmlElement
 *   and overrides of those methods in TaggedElement.
@@ -86,10 +95,13 @@
 
 #include <memory>
 #include <string>
+#include <mutex>
 #include "XmlElement.h"
 
 namespace XmlProcessing
 {
+	class XmlPath;
+
 	///////////////////////////////////////////////////////////////////////////
 	// XmlDocument class
 
@@ -126,13 +138,27 @@ namespace XmlProcessing
 		std::vector<sPtr> select();                             // returns found_.  Uses std::move(found_) to clear found_
 		bool find(const std::string& tag, sPtr pElem, bool findall = true);
 
+		// path queries use a tag index built by the first one, and change no
+		// document state, so any number of threads may run them at once.  The
+		// index holds the elements as they were then: call reindex() after
+		// editing them, while no query is running.
+
+		std::vector<sPtr> select(const XmlPath& path) const;   // e.g., XmlPath("/db/dbRecord/key")
+		void reindex();
+
 		size_t size();
-		std::string toString();
+		std::string toString(XmlOut::Layout layout = XmlOut::pretty);
+		void write(XmlOut& out) { pDocElement_->write(out); }
 		template<typename CallObj>
 		void DFS(sPtr pElem, CallObj& co);
 	private:
+		struct Index;
+		std::shared_ptr<const Index> index() const;
+
 		sPtr pDocElement_;         // AST that holds procInstr, comments, XML root, and more comments
 		std::vector<sPtr> found_;  // query results
+		mutable std::shared_ptr<const Index> pIndex_;  // tag index for path queries, see index()
+		mutable std::mutex indexLock_;                  // held while the index is built
 	};
 
 	//----< search subtree of XmlDocument >------------------------------------
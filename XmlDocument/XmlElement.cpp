@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////
 // XmlElement.cpp - define XML Element types                     //
-// ver 1.8                                                       //
+// ver 2.1                                                       //
 // Application: Help for CSE687 Pr#2, Spring 2015                //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -12,8 +12,51 @@
 
 using namespace XmlProcessing;
 
-size_t AbstractXmlElement::count = 0;
-size_t AbstractXmlElement::tabSize = 2;
+/////////////////////////////////////////////////////////////////////////////
+// XmlOut methods
+
+//----< start a line for an element at this depth >--------------------------
+/*
+*  - pretty layout starts a new line indented by depth tabs
+*  - compact layout writes nothing
+*/
+void XmlOut::line(size_t depth)
+{
+	if (pOut_ && buffer_.size() >= flushSize)
+		flush();
+	if (layout_ == pretty)
+	{
+		buffer_ += '\n';
+		buffer_.append(tabSize_ * depth, ' ');
+	}
+}
+//----< write name="value" >-------------------------------------------------
+
+void XmlOut::attribute(const std::string& name, const std::string& value)
+{
+	buffer_ += ' ';
+	buffer_ += name;
+	buffer_ += "=\"";
+	buffer_ += value;
+	buffer_ += '\"';
+}
+//----< write buffer to stream, if there is one, and empty it >--------------
+
+void XmlOut::flush()
+{
+	if (pOut_ == nullptr || buffer_.size() == 0)
+		return;
+	pOut_->write(buffer_.data(), buffer_.size());
+	buffer_.clear();
+}
+//----< return pretty XML for this element and its children >----------------
+
+std::string AbstractXmlElement::toString()
+{
+	XmlOut out;
+	write(out);
+	return std::move(out.buffer());
+}
 
 //////////////////////////////////////////////////////////////////////////
 // Global Factory methods
@@ -85,7 +128,7 @@ DocElement::DocElement(std::shared_ptr<AbstractXmlElement> pRoot)
 
 bool DocElement::hasXmlRoot()
 {
-	for (auto pElement : children_)
+	for (auto& pElement : children_)
 	{
 		if (dynamic_cast<TaggedElement*>(pElement.get()) != nullptr)
 			return true;
@@ -110,14 +153,14 @@ bool DocElement::addChild(std::shared_ptr<AbstractXmlElement> pChild)
 	TaggedElement* te = dynamic_cast<TaggedElement*>(pChild.get());
 	if (te == nullptr) // is not a TaggedElement
 	{
-		children_.push_back(pChild);
+		children_.push_back(std::move(pChild));
 		return true;
 	}
 
 	// add only one TaggedElement
 	if (!hasXmlRoot())
 	{
-		children_.push_back(pChild);
+		children_.push_back(std::move(pChild));
 		return true;
 	}
 	return false;
@@ -138,14 +181,12 @@ bool DocElement::removeChild(std::shared_ptr<AbstractXmlElement> pChild)
 
 std::string DocElement::value() { return std::string(""); }
 
-//----< generate xml string for tagged element >-----------------------------
+//----< write xml for children, at the doc element's own depth >-------------
 
-std::string DocElement::toString()
+void DocElement::write(XmlOut& out, size_t depth)
 {
-	std::string rtn;
-	for (auto elem : children_)
-		rtn += elem->toString();
-	return rtn;
+	for (auto& pElem : children_)
+		pElem->write(out, depth);
 }
 /////////////////////////////////////////////////////////////////////////////
 // TaggedElement methods
@@ -154,7 +195,7 @@ std::string DocElement::toString()
 
 bool TaggedElement::addChild(std::shared_ptr<AbstractXmlElement> pChild)
 {
-	children_.push_back(pChild);
+	children_.push_back(std::move(pChild));
 	return true;
 }
 //----< remove child from tagged element using pointer to child >------------
@@ -195,38 +236,29 @@ bool TaggedElement::removeAttrib(const std::string& name)
 
 std::string TaggedElement::value() { return tag_; }
 
-//----< generate xml string for tagged element >-----------------------------
+//----< write xml for tagged element, children one level deeper >------------
 
-std::string TaggedElement::toString()
+void TaggedElement::write(XmlOut& out, size_t depth)
 {
-	std::string spacer(tabSize*++count, ' ');
-	std::string xml = "\n" + spacer + "<" + tag_;
-	for (auto at : attribs_)
-	{
-		xml += " ";
-		xml += at.first;
-		xml += "=\"";
-		xml += at.second;
-		xml += "\"";
-	}
-	xml += ">";
-	for (auto pChild : children_)
-		xml += pChild->toString();
-	xml += "\n" + spacer + "</" + tag_ + ">";
-	--count;
-	return xml;
+	out.line(depth);
+	out << '<' << tag_;
+	for (auto& at : attribs_)
+		out.attribute(at.first, at.second);
+	out << '>';
+	for (auto& pChild : children_)
+		pChild->write(out, depth + 1);
+	out.line(depth);
+	out << "</" << tag_ << '>';
 }
 /////////////////////////////////////////////////////////////////////////////
 // TextElement methods
 
-//----< generate xml string for text element >-------------------------------
+//----< write xml for text element >-----------------------------------------
 
-std::string TextElement::toString()
+void TextElement::write(XmlOut& out, size_t depth)
 {
-	std::string spacer(tabSize * ++count, ' ');
-	std::string xml = "\n" + spacer + text_;
-	--count;
-	return xml;
+	out.line(depth);
+	out << text_;
 }
 /////////////////////////////////////////////////////////////////////////////
 // ProcInstrElement methods
@@ -253,44 +285,28 @@ bool ProcInstrElement::removeAttrib(const std::string& name)
 	}
 	return false;
 }
-//----< generate xml string for ProcInstr element >--------------------------
+//----< write xml for ProcInstr element >------------------------------------
 
-std::string ProcInstrElement::toString()
+void ProcInstrElement::write(XmlOut& out, size_t depth)
 {
-	std::string spacer(tabSize*++count, ' ');
-	std::string xml = "\n" + spacer + "<" + "!";
-	for (auto at : attribs_)
-	{
-		xml += " ";
-		xml += at.first;
-		xml += "=\"";
-		xml += at.second;
-		xml += "\"";
-	}
-	xml += "!>";
-	--count;
-	return xml;
+	out.line(depth);
+	out << "<!";
+	for (auto& at : attribs_)
+		out.attribute(at.first, at.second);
+	out << "!>";
 }
 /////////////////////////////////////////////////////////////////////////////
 // XmlDeclarElement methods
 
-//----< generate xml string for text element >-------------------------------
+//----< write xml for xml declaration >--------------------------------------
 
-std::string XmlDeclarElement::toString()
+void XmlDeclarElement::write(XmlOut& out, size_t depth)
 {
-	std::string spacer(tabSize * ++count, ' ');
-	std::string xml = "\n" + spacer + "<?xml";
-	for (auto at : attribs_)
-	{
-		xml += " ";
-		xml += at.first;
-		xml += "=\"";
-		xml += at.second;
-		xml += "\"";
-	}
-	xml += " ?>";
-	--count;
-	return xml;
+	out.line(depth);
+	out << "<?xml";
+	for (auto& at : attribs_)
+		out.attribute(at.first, at.second);
+	out << " ?>";
 }
 //----< add attribute to ProcInstElement >-----------------------------------
 
@@ -317,16 +333,12 @@ bool XmlDeclarElement::removeAttrib(const std::string& name)
 /////////////////////////////////////////////////////////////////////////////
 // CommentElement methods
 
-//----< generate xml string for ProcInstr element >--------------------------
+//----< write xml for comment element >--------------------------------------
 
-std::string CommentElement::toString()
+void CommentElement::write(XmlOut& out, size_t depth)
 {
-	std::string spacer(tabSize*++count, ' ');
-	std::string xml = "\n" + spacer + "<" + "!-- ";
-	xml += commentText_;
-	xml += " -->";
-	--count;
-	return xml;
+	out.line(depth);
+	out << "<!-- " << commentText_ << " -->";
 }
 /////////////////////////////////////////////////////////////////////////////
 // Global Helper Methods
@@ -343,6 +355,9 @@ void XmlProcessing::title(const std::string& title, char underlineChar)
 
 #ifdef TEST_XMLELEMENT
 
+#include <thread>
+#include <algorithm>
+
 int main()
 {
 	title("Testing XmlElement Package", '=');
@@ -367,6 +382,31 @@ int main()
 	std::cout << "\n  attribute value for name = " << "first" << " is \"" << child->attributeValue("first") << "\"\n";
 	sPtr docEl = makeDocElement(root);
 	std::cout << "  " << docEl->toString();
+	std::cout << "\n";
+
+	title("Compact layout, written straight to std::cout");
+	{
+		XmlOut out(std::cout, XmlOut::compact);
+		std::cout << "\n  ";
+		docEl->write(out);
+	}
+	std::cout << "\n";
+
+	title("Serializing from four threads at once");
+	std::string expected = docEl->toString();
+	std::vector<std::thread> threads;
+	std::vector<char> same(4, false);  // not vector<bool>, whose elements share words
+	for (size_t i = 0; i < same.size(); ++i)
+		threads.emplace_back([&, i]() {
+			bool ok = true;
+			for (int n = 0; n < 1000; ++n)
+				ok = ok && docEl->toString() == expected;
+			same[i] = ok;
+		});
+	for (auto& thread : threads)
+		thread.join();
+	bool allSame = std::find(same.begin(), same.end(), false) == same.end();
+	std::cout << "\n  every thread's XML " << (allSame ? "matches" : "differs from") << " the single threaded XML";
 	std::cout << "\n\n";
 }
 
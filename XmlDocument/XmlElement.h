@@ -2,7 +2,7 @@
 #define XMLELEMENT_H
 ///////////////////////////////////////////////////////////////////
 // XmlElement.h - define XML Element types                       //
-// ver 1.8                                                       //
+// ver 2.1                                                       //
 // Application: Help for CSE687 Pr#2, Spring 2015                //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -33,6 +33,14 @@
 *   ProcInstrElement   - XML element with markup and attributes but no children
 *   XmlDeclarElement   - XML declaration
 *
+* Every element writes its XML into an XmlOut, which holds one buffer
+* for the whole tree, the layout - pretty, one element per indented
+* line, or compact, with no whitespace between markup - and, if given
+* one, a std::ostream that the buffer is flushed to as it fills.  So
+* serializing a tree appends each element once, and holds no state
+* outside the XmlOut: threads may serialize at the same time, each
+* into its own XmlOut.  toString() writes a pretty XmlOut of its own.
+*
 * Required Files:
 * ---------------
 *   - XmlElement.h, XmlElement.cpp
@@ -43,6 +51,14 @@
 *
 * Maintenance History:
 * --------------------
+* ver 2.1 : 18 Oct 2026
+* - added XmlOut and write(out, depth), which replaces the toString
+*   overrides; toString is now linear in the size of the XML
+* - removed the static indentation count, so toString is re-entrant
+* ver 2.0 : 18 Oct 2026
+* - ProcInstrElement and XmlDeclarElement return their attributes()
+* ver 1.9 : 18 Oct 2026
+* - addChild moves the child pointer into place rather than copying it
 * ver 1.8 : 02 Feb 2018
 * - added methods:
 *   - AbstractXmlElement::attributes()
@@ -107,9 +123,44 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <ostream>
 
 namespace XmlProcessing
 {
+	/////////////////////////////////////////////////////////////////////////////
+	// XmlOut - the buffer, layout, and optional stream an element writes to
+	// - reuse an XmlOut by calling clear(), which keeps the buffer's memory
+	// - with a stream, the buffer is written out whenever it passes
+	//   flushSize at the start of a line, and when the XmlOut is destroyed
+
+	class XmlOut
+	{
+	public:
+		enum Layout { pretty, compact };
+		static const size_t flushSize = 64 * 1024;
+
+		explicit XmlOut(Layout layout = pretty, size_t tabSize = 2) : layout_(layout), tabSize_(tabSize) {}
+		explicit XmlOut(std::ostream& out, Layout layout = pretty, size_t tabSize = 2)
+			: pOut_(&out), layout_(layout), tabSize_(tabSize) {}
+		XmlOut(const XmlOut&) = delete;
+		XmlOut& operator=(const XmlOut&) = delete;
+		~XmlOut() { flush(); }
+
+		void line(size_t depth);
+		void attribute(const std::string& name, const std::string& value);
+		XmlOut& operator<<(const std::string& s) { buffer_ += s; return *this; }
+		XmlOut& operator<<(const char* s) { buffer_ += s; return *this; }
+		XmlOut& operator<<(char c) { buffer_ += c; return *this; }
+		std::string& buffer() { return buffer_; }
+		void clear() { buffer_.clear(); }
+		void flush();
+	private:
+		std::string buffer_;
+		std::ostream* pOut_ = nullptr;
+		Layout layout_;
+		size_t tabSize_;
+	};
+
 	/////////////////////////////////////////////////////////////////////////////
 	// AbstractXmlElement - base class for all concrete element types
 
@@ -129,11 +180,9 @@ namespace XmlProcessing
 		virtual Attributes attributes();
 		virtual std::string tag() { return ""; }
 		virtual std::string value() = 0;
-		virtual std::string toString() = 0;
+		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1) = 0;
 		virtual ~AbstractXmlElement();
-	protected:
-		static size_t count;
-		static size_t tabSize;
 	};
 
 	inline bool AbstractXmlElement::addChild(std::shared_ptr<AbstractXmlElement> pChild) { return false; }
@@ -168,7 +217,7 @@ namespace XmlProcessing
 		virtual bool removeChild(std::shared_ptr<AbstractXmlElement> pChild);
 		virtual std::vector<sPtr> children();
 		virtual std::string value();
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		bool hasXmlRoot();
 		std::vector<std::shared_ptr<AbstractXmlElement>> children_;
@@ -191,7 +240,7 @@ namespace XmlProcessing
 		TextElement(const TextElement& te) = delete;
 		TextElement& operator=(const TextElement& te) = delete;
 		virtual std::string value();
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		std::string text_;
 	};
@@ -219,7 +268,7 @@ namespace XmlProcessing
 		virtual std::string attributeValue(const std::string& name);
 		virtual std::string tag();
 		virtual std::string value();
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		std::string tag_;
 		std::vector<std::shared_ptr<AbstractXmlElement>> children_;
@@ -259,7 +308,7 @@ namespace XmlProcessing
 		virtual ~CommentElement() {}
 		CommentElement& operator=(const CommentElement& ce) = delete;
 		virtual std::string value() { return commentText_; }
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		std::string commentText_ = "to be defined";
 	};
@@ -279,8 +328,9 @@ namespace XmlProcessing
 		ProcInstrElement& operator=(const ProcInstrElement& pe) = delete;
 		virtual bool addAttrib(const std::string& name, const std::string& value);
 		virtual bool removeAttrib(const std::string& name);
+		virtual Attributes attributes() { return attribs_; }
 		virtual std::string value() { return type_; }
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		std::vector<std::pair<std::string, std::string>> attribs_;
 		std::string type_ = "xml declaration";
@@ -300,8 +350,9 @@ namespace XmlProcessing
 		XmlDeclarElement& operator=(const ProcInstrElement& pe) = delete;
 		virtual bool addAttrib(const std::string& name, const std::string& value);
 		virtual bool removeAttrib(const std::string& name);
+		virtual Attributes attributes() { return attribs_; }
 		virtual std::string value() { return ""; }
-		virtual std::string toString();
+		virtual void write(XmlOut& out, size_t depth = 1);
 	private:
 		std::vector<std::pair<std::string, std::string>> attribs_;
 		std::string type_ = "xml declaration";
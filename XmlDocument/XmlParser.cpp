@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////
 // XmlParser.cpp - build XML parse tree                          //
-// ver 1.4                                                       //
+// ver 1.6                                                       //
 // Application: Support for XmlDocument, Summer 2015             //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -8,11 +8,9 @@
 ///////////////////////////////////////////////////////////////////
 
 #include "XmlParser.h"
-#include "xmlElementParts.h"
 #include "XmlDocument.h"
 #include "XmlElement.h"
 #include "Tokenizer.h"
-#include <stack>
 #include <string>
 #include <cctype>
 #include <locale>
@@ -94,14 +92,15 @@ std::string XmlParser::enquoteText(const std::string& src)
 	}
 	return temp;
 }
-//----< remove quotes, if any, from text string >----------------------------
+//----< copy token out of the source, less any quotes >----------------------
 
-std::string XmlParser::dequoteText(const std::string& src)
+std::string XmlParser::dequoteText(Token src)
 {
 	std::string temp;
-	for (size_t i = 0; i < src.size(); ++i)
-		if (src[i] != '\"' && src[i] != '\'')
-			temp.push_back(src[i]);
+	temp.reserve(src.size);
+	for (size_t i = 0; i < src.size; ++i)
+		if (src.data[i] != '\"' && src.data[i] != '\'')
+			temp.push_back(src.data[i]);
 	return temp;
 }
 //----< initialize XmlParser object with string ready for parsing >----------
@@ -112,26 +111,71 @@ XmlParser::XmlParser(const std::string& src, sourceType type) : src_(src)
 		src_ = textFileToString(src_);
 	compress(src_);
 	src_ = enquoteText(src_);
-	pToker_ = new Toker(src_, false);
-	pToker_->setMode(Toker::xml);
-	pXmlParts_ = new XmlParts(pToker_);
+	pToker_.reset(new BufferToker(src_));  // reads src_ in place, so src_ must not change
 }
-//----< extract attributes, if any, from XmlParts token collection >---------
+//----< collect the tokens of the next markup or text >----------------------
+/*
+*  Collects the same parts XmlParts::get does, as views into src_,
+*  ending after ">" or before the "<" that starts the next markup.
+*/
+bool XmlParser::getParts()
+{
+	parts_.clear();
+	bool terminated = false;
+	do
+	{
+		if (pToker_->isFileEnd())
+			return parts_.size() > 0;
+		Token tok = pToker_->getTok();
+		if (parts_.size() > 0 && tok == "<")
+		{
+			pToker_->putback('<');
+			break;
+		}
+		if (tok != "\n")
+			parts_.push_back(tok);
+		terminated = tok == ">";
+	} while (!terminated);
+	return true;
+}
+//----< return part n of the current markup or text >------------------------
+
+XmlParser::Token XmlParser::part(size_t n)
+{
+	if (parts_.size() <= n)
+		throw(std::exception("XmlParser part index out of range"));
+	return parts_[n];
+}
+//----< show the current parts as a space separated string >-----------------
+
+std::string XmlParser::showParts()
+{
+	if (parts_.size() == 0)
+		return "";
+	std::string temp(" ");
+	for (auto tok : parts_)
+		temp.append(" ").append(tok.data, tok.size);
+	return temp;
+}
+//----< make an element in the document's arena >----------------------------
+
+template<typename Elem, typename... Args>
+XmlParser::sPtr XmlParser::make(Args&&... args)
+{
+	return std::allocate_shared<Elem>(XmlArenaAllocator<Elem>(pArena_), std::forward<Args>(args)...);
+}
+//----< extract attributes, if any, from the current parts >-----------------
 
 void XmlParser::extractAttributes()
 {
 	attribs_.clear();
-	XmlParts xmlParts = *pXmlParts_;
-	for (size_t pos = 0; pos < (size_t)xmlParts.length(); ++pos)
+	for (size_t pos = 0; pos < parts_.size(); ++pos)
 	{
-		if (xmlParts[pos] == "=")
-		{
-			auto item = attrib(xmlParts[pos - 1], xmlParts[pos + 1]);
-			attribs_.push_back(item);
-		}
+		if (parts_[pos] == "=")
+			attribs_.push_back(attrib(part(pos - 1), part(pos + 1)));
 	}
 }
-//----< display all attribute name-value pairs in current XmlParts >---------
+//----< display all attribute name-value pairs in current parts >------------
 
 void XmlParser::showAttributes()
 {
@@ -139,7 +183,7 @@ void XmlParser::showAttributes()
 		return;
 	for (size_t i = 0; i < attribs_.size(); ++i)
 	{
-		std::cout << "\n      " << attribs_[i].first << ", " << attribs_[i].second;
+		std::cout << "\n      " << attribs_[i].first.str() << ", " << attribs_[i].second.str();
 	}
 }
 //----< factory for XmlDeclaration node >------------------------------------
@@ -147,16 +191,12 @@ void XmlParser::showAttributes()
 XmlParser::sPtr XmlParser::createXmlDeclar()
 {
 	extractAttributes();
-	sPtr pDeclar = makeXmlDeclarElement();
+	sPtr pDeclar = make<XmlDeclarElement>();
 	for (auto item : attribs_)
-	{
-		std::string name = item.first;
-		std::string value = dequoteText(item.second);
-		pDeclar->addAttrib(name, value);
-	}
+		pDeclar->addAttrib(item.first.str(), dequoteText(item.second));
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
+		std::cout << "\n  " << showParts();
 		std::cout << "\n    xml declaration";
 		showAttributes();
 	}
@@ -167,16 +207,12 @@ XmlParser::sPtr XmlParser::createXmlDeclar()
 XmlParser::sPtr XmlParser::createProcInstr()
 {
 	extractAttributes();
-	sPtr pProcInstr = makeProcInstrElement("");
+	sPtr pProcInstr = make<ProcInstrElement>("");
 	for (auto item : attribs_)
-	{
-		std::string name = item.first;
-		std::string value = dequoteText(item.second);
-		pProcInstr->addAttrib(name, value);
-	}
+		pProcInstr->addAttrib(item.first.str(), dequoteText(item.second));
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
+		std::cout << "\n  " << showParts();
 		std::cout << "\n    processing instruction";
 		showAttributes();
 	}
@@ -187,39 +223,32 @@ XmlParser::sPtr XmlParser::createProcInstr()
 XmlParser::sPtr XmlParser::createComment()
 {
 	std::string comment;
-	XmlParts& xmlParts = *pXmlParts_;
-	for (size_t i = 3; i < (size_t)xmlParts.length() - 2; ++i)
+	for (size_t i = 3; i < parts_.size() - 2; ++i)
 	{
-		comment += xmlParts[i];
-		if (i < (size_t)xmlParts.length() - 3)
+		comment.append(parts_[i].data, parts_[i].size);
+		if (i < parts_.size() - 3)
 			comment += " ";
 	}
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
+		std::cout << "\n  " << showParts();
 		std::cout << "\n    comment";
 		std::cout << "\n      " << comment;
 	}
-	sPtr pComment = makeCommentElement(comment);
-	return pComment;
+	return make<CommentElement>(comment);
 }
 //----< factory for Tagged Element node >------------------------------------
 
 XmlParser::sPtr XmlParser::createTaggedElem()
 {
-	XmlParts& xmlParts = *pXmlParts_;
-	sPtr pTaggedElem = makeTaggedElement(xmlParts[1]);
+	sPtr pTaggedElem = make<TaggedElement>(part(1).str());
 	extractAttributes();
 	for (auto item : attribs_)
-	{
-		std::string name = item.first;
-		std::string value = dequoteText(item.second);
-		pTaggedElem->addAttrib(name, value);
-	}
+		pTaggedElem->addAttrib(item.first.str(), dequoteText(item.second));
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
-		std::cout << "\n    tagged element " << "\"" << xmlParts[1] << "\"";
+		std::cout << "\n  " << showParts();
+		std::cout << "\n    tagged element " << "\"" << part(1).str() << "\"";
 		showAttributes();
 	}
 	return pTaggedElem;
@@ -228,26 +257,19 @@ XmlParser::sPtr XmlParser::createTaggedElem()
 
 XmlParser::sPtr XmlParser::createTextElem()
 {
-	XmlParts& xmlParts = *pXmlParts_;
-	std::string text = dequoteText(xmlParts[0]);
+	std::string text = dequoteText(part(0));
 
 	// trim trailing whitespace
 	std::locale loc;
-	while (true)
-	{
-		if (isspace(*(--text.end()), loc))
-			text.erase(--text.end());
-		else
-			break;
-	}
+	while (text.size() > 0 && isspace(text.back(), loc))
+		text.pop_back();
 
-	sPtr pTextElem = makeTextElement(text);
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
+		std::cout << "\n  " << showParts();
 		std::cout << "\n    Text Element";
 	}
-	return pTextElem;
+	return make<TextElement>(text);
 }
 //----< show end element parts >---------------------------------------------
 
@@ -255,7 +277,7 @@ void XmlParser::processEndElem()
 {
 	if (verbose_)
 	{
-		std::cout << "\n  " << pXmlParts_->show();
+		std::cout << "\n  " << showParts();
 		std::cout << "\n    end element";
 	}
 }
@@ -263,39 +285,32 @@ void XmlParser::processEndElem()
 
 void XmlParser::processMarkup(ElemStack& elemStack)
 {
-	XmlParts& xmlParts = *pXmlParts_;
-	if (xmlParts[1] == "?")
+	if (part(1) == "?")
 	{
-		if (xmlParts[2] == "xml")
-		{
-			sPtr pDeclar = createXmlDeclar();
-			elemStack.top()->addChild(pDeclar);
-		}
+		if (part(2) == "xml")
+			elemStack.back()->addChild(createXmlDeclar());
 		else
-		{
-			sPtr pProcInstr = createProcInstr();
-			elemStack.top()->addChild(pProcInstr);
-		}
+			elemStack.back()->addChild(createProcInstr());
 		if (verbose_) std::cout << "\n";
 		return;
 	}
-	if (xmlParts[1] == "!")
+	if (part(1) == "!")
 	{
-		sPtr pComment = createComment();
-		elemStack.top()->addChild(pComment);
+		elemStack.back()->addChild(createComment());
 		if (verbose_) std::cout << "\n";
 		return;
 	}
-	if (xmlParts[1] == "/")
+	if (part(1) == "/")
 	{
 		processEndElem();
-		elemStack.pop();
+		elemStack.pop_back();
 	}
 	else
 	{
 		sPtr pTaggedElem = createTaggedElem();
-		elemStack.top()->addChild(pTaggedElem);
-		elemStack.push(pTaggedElem);
+		AbstractXmlElement* pElem = pTaggedElem.get();
+		elemStack.back()->addChild(std::move(pTaggedElem));
+		elemStack.push_back(pElem);
 	}
 	if (verbose_) std::cout << "\n";
 	return;
@@ -304,33 +319,34 @@ void XmlParser::processMarkup(ElemStack& elemStack)
 
 void XmlParser::processText(ElemStack& elemStack)
 {
-	sPtr pTextElem = createTextElem();
-	elemStack.top()->addChild(pTextElem);
+	elemStack.back()->addChild(createTextElem());
 	if (verbose_) std::cout << "\n";
 }
-//----< build XmlDocument from XmlParts >------------------------------------
-
+//----< build XmlDocument from parts of the source >-------------------------
+/*
+*  Every element, and the document element, comes from a new arena
+*  held by the elements of this document.
+*/
 XmlDocument* XmlParser::buildDocument()
 {
-	XmlDocument* pDoc = new XmlDocument(makeDocElement());
-	using sPtr = std::shared_ptr < AbstractXmlElement >;
-	sPtr pDocElem = pDoc->docElement();
+	pArena_ = std::make_shared<XmlArena>();
+	XmlDocument* pDoc = new XmlDocument(make<DocElement>());
 
-	std::stack <sPtr> elemStack_;
-	elemStack_.push(pDocElem);
+	ElemStack elemStack;
+	elemStack.push_back(pDoc->docElement().get());
 
 	std::locale loc;
-	XmlParts& xmlParts = *pXmlParts_;
-	while (xmlParts.get())
+	while (getParts())
 	{
-		if (xmlParts[0] == "<")
+		if (parts_[0] == "<")
 		{
-			processMarkup(elemStack_);
+			processMarkup(elemStack);
 			continue;
 		}
-		if (xmlParts[0][0] == '\"' || isalnum(xmlParts[0][0]) || isspace(xmlParts[0][0], loc))
+		char first = parts_[0].empty() ? '\0' : parts_[0].data[0];
+		if (first == '\"' || isalnum(first) || isspace(first, loc))
 		{
-			processText(elemStack_);
+			processText(elemStack);
 			continue;
 		}
 		throw(std::exception("ill-formed XML"));
@@ -357,6 +373,13 @@ int main()
 	XmlDocument* pDoc = parser.buildDocument();
 	Utils::title("Resulting XML Parse Tree:");
 	std::cout << "\n" << pDoc->toString();
+	delete pDoc;
+
+	Utils::title("Parsing an XML string into a document arena:");
+	XmlParser strParser("<root a=\"1\"><child>some text</child><!-- note --></root>", XmlParser::str);
+	std::unique_ptr<XmlDocument> pStrDoc(strParser.buildDocument());
+	std::cout << "\n" << pStrDoc->toString();
+	std::cout << "\n  root has " << pStrDoc->xmlRoot()->children().size() << " children";
 	std::cout << "\n\n";
 }
 
@@ -2,7 +2,7 @@
 #define XMLPARSER_H
 ///////////////////////////////////////////////////////////////////
 // XmlParser.h - build XML parse tree                            //
-// ver 1.4                                                       //
+// ver 1.6                                                       //
 // Application: Support for XmlDocument, Summer 2015             //
 // Platform:    Dell XPS 2720, Win 8.1 Pro, Visual Studio 2013   //
 // Author:      Jim Fawcett, CST 4-187, 443-3948                 //
@@ -21,10 +21,18 @@
 *
 * XmlParser objects throw if given an invalid path to an XML file.
 *
+* The parser reads its tokens in place, as views into the source
+* string, and collects the parts of each element into a reused vector,
+* so parsing copies no token.  Element stack entries are plain pointers.
+* Elements are made with std::allocate_shared in an XmlArena belonging
+* to the document, so a parse allocates one chunk per batch of
+* elements, not one block per element, and the only shared_ptr made
+* for an element is the one its parent holds.
+*
 * Required Files:
 * ---------------
 *   - XmlParser.h, XmlParser.cpp,
-*   - XmlElementParts.h, XmlElementParts.cpp
+*   - XmlArena.h
 *   - XmlDocument.h, XmlDocument.cpp, XmlElement.h, XmlElement.cpp
 *   - ITokenCollection.h, Tokenizer.h, Tokenizer.cpp
 *   - Utilities.Lib
@@ -35,6 +43,13 @@
 *
 * Maintenance History:
 * --------------------
+* ver 1.6 : 18 Oct 2026
+* - collects token views from BufferToker itself rather than strings
+*   from XmlParts, and makes elements in a per-document XmlArena
+* - element stack holds raw pointers
+* - the tokenizer is owned by a unique_ptr, so it is no longer leaked
+* ver 1.5 : 18 Oct 2026
+* - tokenizes its source string in place with BufferToker
 * ver 1.4 : 31 Jan 18
 * - added trimming of text end in XmlParser::createTextElement()
 * Ver 1.3 : 01 Jun 15
@@ -57,11 +72,10 @@
 *   - rigourous testing
 */
 
-#include "itokcollection.h"
-#include "xmlElementParts.h"
+#include "Tokenizer.h"
 #include "XmlElement.h"
+#include "XmlArena.h"
 #include <vector>
-#include <stack>
 #include <memory>
 
 namespace XmlProcessing
@@ -72,9 +86,11 @@ namespace XmlProcessing
 	{
 	public:
 		using sPtr = std::shared_ptr < AbstractXmlElement >;
-		using attrib = std::pair < std::string, std::string >;
+		using Token = BufferToker::Token;
+		using Parts = std::vector < Token >;
+		using attrib = std::pair < Token, Token >;
 		using attribs = std::vector <attrib>;
-		using ElemStack = std::stack < sPtr >;
+		using ElemStack = std::vector < AbstractXmlElement* >;
 
 		enum sourceType { file, str };
 		XmlParser(const std::string& src, sourceType type = file);
@@ -85,7 +101,12 @@ namespace XmlProcessing
 		std::string textFileToString(const std::string& fileSpec);
 		void compress(std::string& xmlStr);
 		std::string enquoteText(const std::string& src);
-		std::string dequoteText(const std::string& src);
+		std::string dequoteText(Token src);
+		bool getParts();
+		Token part(size_t n);
+		std::string showParts();
+		template<typename Elem, typename... Args>
+		sPtr make(Args&&... args);
 		sPtr createXmlDeclar();
 		sPtr createProcInstr();
 		sPtr createComment();
@@ -98,9 +119,9 @@ namespace XmlProcessing
 		void showAttributes();
 		attribs& attributes();
 		attribs attribs_;
-		ITokCollection* pTokColl_;
-		XmlParts* pXmlParts_;
-		Toker* pToker_ = nullptr;
+		Parts parts_;
+		std::unique_ptr<BufferToker> pToker_;
+		std::shared_ptr<XmlArena> pArena_;
 		std::string src_;
 		bool verbose_ = false;
 		bool good_ = false;
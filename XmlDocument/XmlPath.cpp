@@ -0,0 +1,266 @@
+/////////////////////////////////////////////////////////////////////////////////////
+// XmlPath.cpp - compiled path queries over a tag indexed XML document             //
+// ver 1.0                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "XmlPath.h"
+
+using namespace XmlProcessing;
+using NodeId = XmlPath::NodeId;
+using TagId = XmlPath::TagId;
+
+//----< compile path, throwing if it is ill-formed >-------------------------
+
+XmlPath::XmlPath(const std::string& path) : path_(path)
+{
+	compile();
+}
+//----< split path_ into steps >---------------------------------------------
+
+void XmlPath::compile()
+{
+	auto fail = [&](const std::string& why) {
+		throw(std::exception(("ill-formed XmlPath \"" + path_ + "\": " + why).c_str()));
+	};
+	const std::string& p = path_;
+	size_t pos = 0;
+	if (p.size() == 0)
+		fail("path is empty");
+	while (pos < p.size())
+	{
+		Step step;
+		if (p[pos] != '/')
+			fail("steps must start with / or //");
+		if (++pos < p.size() && p[pos] == '/')
+		{
+			step.descendent = true;
+			++pos;
+		}
+		size_t start = pos;
+		while (pos < p.size() && p[pos] != '/' && p[pos] != '[')
+			++pos;
+		step.tag = p.substr(start, pos - start);
+		if (step.tag.size() == 0)
+			fail("step has no tag");
+		step.anyTag = step.tag == "*";
+
+		if (pos < p.size() && p[pos] == '[')
+		{
+			if (++pos == p.size() || p[pos] != '@')
+				fail("only [@name] and [@name='value'] tests are supported");
+			start = ++pos;
+			while (pos < p.size() && p[pos] != '=' && p[pos] != ']')
+				++pos;
+			step.attribName = p.substr(start, pos - start);
+			if (step.attribName.size() == 0)
+				fail("attribute test has no name");
+			step.hasAttrib = true;
+			if (pos < p.size() && p[pos] == '=')
+			{
+				if (++pos == p.size() || (p[pos] != '\'' && p[pos] != '\"'))
+					fail("attribute value must be quoted");
+				char quote = p[pos++];
+				size_t close = p.find(quote, pos);
+				if (close == std::string::npos)
+					fail("attribute value has no closing quote");
+				step.attribValue = p.substr(pos, close - pos);
+				step.hasValue = true;
+				pos = close + 1;
+			}
+			if (pos == p.size() || p[pos] != ']')
+				fail("attribute test has no closing ]");
+			++pos;
+		}
+		steps_.push_back(step);
+	}
+}
+//----< return ids of the elements path selects, in document order >--------
+
+std::vector<NodeId> XmlPath::select(const FlatXmlDocument& doc) const
+{
+	std::vector<NodeId> found;
+	select(doc, found);
+	return found;
+}
+//----< replace found with ids of the elements path selects >---------------
+/*
+*  Candidates come from the tag index entry of the last step's tag, or
+*  are every element if that step is "*".
+*/
+void XmlPath::select(const FlatXmlDocument& doc, std::vector<NodeId>& found) const
+{
+	found.clear();
+	std::vector<TagId> tags(steps_.size(), TagId(FlatXmlDocument::noTag));
+	for (size_t i = 0; i < steps_.size(); ++i)
+	{
+		if (!steps_[i].anyTag && !doc.findTag(steps_[i].tag, tags[i]))
+			return;  // no element has this tag, so nothing matches
+	}
+	size_t last = steps_.size() - 1;
+	if (steps_[last].anyTag)
+	{
+		for (NodeId id = doc.docElem() + 1, end = doc.end(doc.docElem()); id < end; ++id)
+		{
+			if (matches(doc, tags, id, last))
+				found.push_back(id);
+		}
+		return;
+	}
+	for (NodeId id : doc.nodesWithTag(tags[last]))
+	{
+		if (matches(doc, tags, id, last))
+			found.push_back(id);
+	}
+}
+//----< does element id match steps [0, step], ending with step? >----------
+/*
+*  A "//" step may match at any depth, so its ancestors are tried in
+*  turn until one matches the step before.
+*/
+bool XmlPath::matches(const FlatXmlDocument& doc, const std::vector<TagId>& tags, NodeId id, size_t step) const
+{
+	const Step& current = steps_[step];
+	if (!matchesStep(doc, tags[step], id, current))
+		return false;
+	NodeId up = doc.parent(id);
+	if (step == 0)
+		return current.descendent || up == doc.docElem();
+	if (!current.descendent)
+		return matches(doc, tags, up, step - 1);
+	for (; up != doc.docElem(); up = doc.parent(up))
+	{
+		if (matches(doc, tags, up, step - 1))
+			return true;
+	}
+	return false;
+}
+//----< does element id have the step's tag and attribute? >----------------
+
+bool XmlPath::matchesStep(const FlatXmlDocument& doc, TagId tag, NodeId id, const Step& step) const
+{
+	if (doc.kind(id) != FlatXmlDocument::taggedElement)
+		return false;
+	if (!step.anyTag && doc.tagId(id) != tag)
+		return false;
+	if (!step.hasAttrib)
+		return true;
+	for (size_t i = 0; i < doc.attributeCount(id); ++i)
+	{
+		const FlatXmlDocument::Attribute& attrib = doc.attribute(id, i);
+		if (attrib.first == step.attribName)
+			return !step.hasValue || attrib.second == step.attribValue;
+	}
+	return false;
+}
+
+#ifdef TEST_XMLPATH
+
+#include <thread>
+
+/////////////////////////////////////////////////////////////////////////////
+// Test Functions
+
+using sPtr = XmlDocument::sPtr;
+
+const std::string testXml =
+	"<?xml version=\"1.0\"?>"
+	"<db>"
+	"<dbRecord type=\"file\"><key>one</key><value><payload><category>code</category><category>test</category></payload></value></dbRecord>"
+	"<dbRecord type=\"dir\"><key>two</key><value><payload><category>docs</category></payload></value></dbRecord>"
+	"<dbRecord><key>three</key><children><key>one</key><key>two</key></children></dbRecord>"
+	"</db>";
+
+//----< run a path query, show what it selects, and check the count >--------
+
+bool check(const XmlDocument& doc, const std::string& path, size_t expected)
+{
+	std::vector<sPtr> found = doc.select(XmlPath(path));
+	std::cout << "\n  " << path << " selects " << found.size() << ":";
+	for (auto pElem : found)
+	{
+		std::cout << " " << pElem->tag();
+		if (pElem->children().size() == 1)
+			std::cout << "(" << pElem->children()[0]->value() << ")";
+	}
+	return found.size() == expected;
+}
+//----< test stub >----------------------------------------------------------
+
+int main()
+{
+	title("Testing XmlPath class");
+
+	XmlDocument doc(testXml, XmlDocument::str);
+	std::cout << doc.toString() << "\n";
+
+	bool ok = true;
+	title("testing child, descendent and wildcard steps");
+	ok = check(doc, "/db/dbRecord/key", 3) && ok;
+	ok = check(doc, "/db/dbRecord/value/payload/category", 3) && ok;
+	ok = check(doc, "//key", 5) && ok;
+	ok = check(doc, "/db//key", 5) && ok;
+	ok = check(doc, "/db/dbRecord/children/key", 2) && ok;
+	ok = check(doc, "/db/*/key", 3) && ok;
+	ok = check(doc, "//dbRecord//category", 3) && ok;
+	ok = check(doc, "/dbRecord", 0) && ok;
+	ok = check(doc, "//foobar", 0) && ok;
+	std::cout << "\n";
+
+	title("testing attribute tests");
+	ok = check(doc, "//dbRecord[@type]", 2) && ok;
+	ok = check(doc, "//dbRecord[@type='dir']/key", 1) && ok;
+	ok = check(doc, "/db/dbRecord[@type=\"file\"]//category", 2) && ok;
+	ok = check(doc, "//dbRecord[@type='none']", 0) && ok;
+	std::cout << "\n";
+
+	title("testing //tag matches descendents(tag)");
+	ok = ok && doc.select(XmlPath("//category")) == doc.descendents("category").select();
+
+	title("testing ill-formed paths");
+	for (std::string path : { "", "db", "/db/", "//", "/db[type]", "/db[@type='x]", "/db[@type" })
+	{
+		try
+		{
+			XmlPath bad(path);
+			std::cout << "\n  \"" << path << "\" was accepted";
+			ok = false;
+		}
+		catch (std::exception& ex)
+		{
+			std::cout << "\n  " << ex.what();
+		}
+	}
+	std::cout << "\n";
+
+	title("testing queries from four threads on one document");
+	XmlPath keys("//key");
+	std::vector<sPtr> expected = doc.select(keys);
+	doc.reindex();
+	std::vector<char> good(4, 0);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < good.size(); ++i)
+	{
+		threads.emplace_back([&, i]() {
+			bool same = true;
+			for (size_t n = 0; n < 1000; ++n)
+				same = same && doc.select(keys) == expected;
+			good[i] = same;
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	for (char same : good)
+		ok = ok && same;
+
+	std::cout << "\n  path queries " << (ok ? "passed" : "failed") << "\n\n";
+	return ok ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef XMLPATH_H
+#define XMLPATH_H
+/////////////////////////////////////////////////////////////////////////////////////
+// XmlPath.h - compiled path queries over a tag indexed XML document               //
+// ver 1.0                                                                         //
+//                                                                                 //
+// Environment : C++ Console Application                                           //
+// Platform    : Windows 10 Home x64, Lenovo IdeaPad 700, Visual Studio 2017       //
+// Application :  NoSqlDb Key/Value database prototype for CSE687-OOD, Spring 2018 //
+// Author: Theerut Foongkiatcharoen, EECS Department, Syracuse University          //
+//         tfoongki@syr.edu                                                        //
+/////////////////////////////////////////////////////////////////////////////////////
+/*
+* Package Operations:
+* -------------------
+* XmlPath compiles a small subset of XPath once, into a list of steps,
+* and then selects the tagged elements of any FlatXmlDocument it
+* matches.  A path is a sequence of steps, each one of:
+*   /tag              - a child element with this tag
+*   //tag             - a descendent element with this tag
+* where tag may be * to match any tag,
+* and each step may end with one attribute test:
+*   [@name]           - the element has this attribute
+*   [@name='value']   - the attribute has this value, "" quotes work too
+* e.g., /db/dbRecord/value/payload/category or //dbRecord[@type='x']/key
+*
+* Selection starts from the document's tag index, not from the root:
+* the candidates are the elements with the last step's tag, and each is
+* kept if its ancestors match the earlier steps.  So a query costs about
+* the number of elements with that tag times the depth of the path,
+* however large the rest of the document is.  Results are in document
+* order, with no duplicates.
+*
+* select is const, and reads nothing but the document, so one XmlPath
+* may be used by many threads at once, on one document or many.  See
+* XmlDocument::select(const XmlPath&) for queries that return elements.
+*
+* Public Interface:
+* -----------------
+*   XmlPath path("/db/dbRecord/key");    // throws if path is ill-formed
+*   std::vector<NodeId> ids = path.select(flatDoc);
+*   path.select(flatDoc, ids);           // reuses ids' memory
+*
+* Required Files:
+* ---------------
+*   - XmlPath.h, XmlPath.cpp
+*   - FlatXmlDocument.h, FlatXmlDocument.cpp
+*
+* Build Process:
+* --------------
+*   devenv XmlParser.sln /debug rebuild
+*
+* Maintenance History:
+* --------------------
+* ver 1.0 : 18 Oct 2026
+* - first release
+*/
+
+#include <string>
+#include <vector>
+#include "FlatXmlDocument.h"
+
+namespace XmlProcessing
+{
+	///////////////////////////////////////////////////////////////////////////
+	// XmlPath class
+
+	class XmlPath
+	{
+	public:
+		using NodeId = FlatXmlDocument::NodeId;
+		using TagId = FlatXmlDocument::TagId;
+
+		explicit XmlPath(const std::string& path);
+		std::vector<NodeId> select(const FlatXmlDocument& doc) const;
+		void select(const FlatXmlDocument& doc, std::vector<NodeId>& found) const;
+		const std::string& path() const { return path_; }
+		size_t steps() const { return steps_.size(); }
+	private:
+		struct Step
+		{
+			bool descendent = false;  // "//" rather than "/"
+			bool anyTag = false;      // "*"
+			std::string tag;
+			bool hasAttrib = false;
+			bool hasValue = false;
+			std::string attribName;
+			std::string attribValue;
+		};
+
+		void compile();
+		bool matches(const FlatXmlDocument& doc, const std::vector<TagId>& tags, NodeId id, size_t step) const;
+		bool matchesStep(const FlatXmlDocument& doc, TagId tag, NodeId id, const Step& step) const;
+
+		std::string path_;
+		std::vector<Step> steps_;
+	};
+}
+#endif
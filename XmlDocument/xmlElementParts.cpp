@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  XmlElementParts.cpp - Collects tokens for XML analysis         //
-//  ver 1.3                                                        //
+//  ver 1.4                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -17,52 +17,57 @@
 XmlParts::XmlParts(Toker* pTokr) : pToker(pTokr), Verbose(false)
 {
 }
-//----< destructor >-------------------------------------------
+//----< construct XmlParts instance that reads a buffer >------
 
-XmlParts::~XmlParts()
+XmlParts::XmlParts(BufferToker* pTokr) : pToker(nullptr), pBufferToker(pTokr), Verbose(false)
 {
 }
-//----< is this a terminating token? >-------------------------
+//----< destructor >-------------------------------------------
 
-bool XmlParts::isTerminator(std::string tok)
+XmlParts::~XmlParts()
 {
-	if (tok.length() == 0)
-		return false;
-	if (tok == ">")
-		return true;
-	return false;
 }
 //
 //----< collect an XmlElementParts sequence >------------------
 
 bool XmlParts::get()
+{
+	if (pBufferToker)
+		return collect(pBufferToker);
+	return collect(pToker);
+}
+//----< collect tokens from either kind of toker >-------------
+
+template<typename Tokr>
+bool XmlParts::collect(Tokr* pTokr)
 {
 	toks.clear();
-	std::string tok;
+	bool terminated = false;
 	do
 	{
-		if (pToker->isFileEnd())
+		if (pTokr->isFileEnd())
 		{
 			if (length() > 0)
 				return true;
 			return false;
 		}
-		tok = pToker->getTok();
+		auto tok = pTokr->getTok();
 		if (Verbose)
 		{
 			if (tok != "\n")
-				std::cout << "\n--tok=" << tok << std::endl;
+				std::cout << "\n--tok=" << std::string(tok) << std::endl;
 			else
 				std::cout << "\n--tok=newline\n";
 		}
 		if (toks.size() > 0 && tok == "<")
 		{
-			pToker->putback('<');
+			pTokr->putback('<');
 			break;
 		}
 		if (tok != "\n")
-			toks.push_back(tok);
-	} while (!isTerminator(tok));
+			toks.push_back(std::string(tok));
+		terminated = tok == ">";
+	} while (!terminated);
 	return true;
 }
 //----< index operator >---------------------------------------
@@ -2,7 +2,7 @@
 #define XMLELEMENTPARTS_H
 /////////////////////////////////////////////////////////////////////
 //  XmlElementParts.h - Collects tokens for XML analysis           //
-//  ver 1.3                                                        //
+//  ver 1.4                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -25,6 +25,9 @@ without having to save part of the sequence for later use or get more
 to complete the detection process.  This simplifies the design of code
 analysis tools.
 
+XmlParts may take its tokens from a Toker, or from a BufferToker, which
+reads them in place from a buffer instead of a stream.
+
 Note that assignment and copying of XmlParts instances is supported, using
 the default operations provided by the C++ language.  Copies and assignments
 result in both source and target XmlParts instances sharing the same toker.
@@ -33,6 +36,8 @@ Public Interface:
 =================
 Toker t;                                  // create tokenizer instance
 XmlParts parts(&t);                       // create instance and attach
+BufferToker bt(someXml);                  // or tokenize a buffer in place
+XmlParts bufferParts(&bt);
 if(xml.get())                             // collect an XmlElementParts
 std::cout << parts.showXmlParts().c_str();  // show it
 int n = parts.length();                   // number of tokens in parts
@@ -52,6 +57,8 @@ Build commands (either one)
 
 Maintenance History:
 ====================
+ver 1.4 : 18 Oct 2026
+- tokens may come from a BufferToker
 ver 1.3 : 31 Jan 09
 - fixed bug identified by Phil Pratt-Szeliga where white space before
 an internal '<' character caused a parsing error.  The solution used
@@ -73,6 +80,7 @@ class XmlParts : public ITokCollection
 {
 public:
 	XmlParts(Toker* pTokr);
+	XmlParts(BufferToker* pTokr);
 	XmlParts();
 	~XmlParts();
 	bool get();
@@ -89,12 +97,14 @@ public:
 
 private:
 	Toker* pToker;
+	BufferToker* pBufferToker = nullptr;
 	std::vector<std::string> toks;
-	bool isTerminator(std::string tok);
+	template<typename Tokr>
+	bool collect(Tokr* pTokr);
 	bool Verbose;
 };
 
-inline XmlParts::XmlParts() : pToker(nullptr) {}
+inline XmlParts::XmlParts() : pToker(nullptr), Verbose(false) {}
 
 inline int XmlParts::length() { return (int)toks.size(); }
 